@@ -28,9 +28,19 @@
 
 #include "nova.h"
 #include "lumen.h"
+#include "lumenkernels.h"
+#include "checkpoint.h"
+#include "recorder.h"
+#include "simulator.h"
+#include "threadpool.h"
+#include "sharednova.h"
+#include "commandqueue.h"
 #include <iostream>
+#include <cstdio>
 #include <memory>
+#include <unordered_set>
 #include <stdlib.h>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -166,10 +176,405 @@ void testNovaMoveSemantics() {
     
 }
 
+void testNovaRvalueOperators() {
+
+    std::cout << "\nTesting RVALUE OPERATORS..." << std::endl;
+
+    Lumen** lumens1 = new Lumen*[12];
+    Lumen** lumens2 = new Lumen*[12];
+    Nova nova1(100, 10, 30, 12, lumens1);
+    Nova nova2(50, 5, 20, 12, lumens2);
+
+    // Only the first + copies, the rest of the chain reuses that temporary
+    Nova chained = nova1 + nova2 + nova2 - nova2 + 10;
+    std::cout << "Glow chained max value: " << chained.getMaxGlow() << " | Glow chained min value:" << chained.getMinGlow() << std::endl;
+
+    // Reallocation moves the novas since the move constructor is noexcept
+    std::vector<Nova> novas;
+    for (int i = 0; i < 4; ++i) {
+        novas.push_back(nova1 + i);
+    }
+    std::cout << "Glow last max value: " << novas.back().getMaxGlow() << std::endl;
+}
+
+void testNovaResizing() {
+
+    std::cout << "\nTesting RESIZING..." << std::endl;
+
+    Lumen** lumens = new Lumen*[4];
+    Nova nova(100, 10, 30, 4, lumens);
+
+    // Grow past the injected array, then retire a lumen and add another into its slot
+    int added = nova.addLumen(40, 4, 80);
+    nova.addLumen(60, 6, 120);
+    nova.removeLumen(added);
+    int reused = nova.addLumen(20, 2, 50);
+
+    std::cout << "Reused slot: " << (reused == added) << std::endl;
+    std::cout << "Lumens: " << nova.getLumenCount() << " | Slots: " << nova.getSlotCount() << " | Capacity: " << nova.getCapacity() << std::endl;
+
+    nova.removeLumen(0);
+    nova.glow(nova.getSlotCount());
+    std::cout << "Glow nova max value: " << nova.getMaxGlow() << " | Glow nova min value:" << nova.getMinGlow() << std::endl;
+}
+
+void testNovaCheckpoints() {
+
+    std::cout << "\nTesting CHECKPOINTS..." << std::endl;
+
+    Lumen** lumens = new Lumen*[12];
+    Nova nova(100, 10, 30, 12, lumens);
+    std::remove("nova.journal");
+    CheckpointJournal journal("nova.journal");
+
+    // A new nova is all dirty, so the first checkpoint holds every slot
+    journal.checkpoint(nova);
+    nova.glow(3);
+    std::cout << "Dirty after glow(3): " << nova.getDirtyCount() << std::endl;
+    journal.checkpoint(nova);
+    nova.removeLumen(5);
+    journal.checkpoint(nova);
+
+    Nova replayed = journal.replay();
+    std::cout << "Replay matches: " << (replayed == nova) << " | Journal bytes: " << journal.getJournalSize() << std::endl;
+
+    journal.compact();
+    Nova compacted = journal.replay();
+    std::cout << "Compacted matches: " << (compacted == nova) << " | Journal bytes: " << journal.getJournalSize() << std::endl;
+
+    // Slot 8 was vacated after slot 5, so it is the one the next add reuses, before and after recovery
+    nova.removeLumen(8);
+    journal.checkpoint(nova);
+    Nova recovered = journal.replay();
+    std::cout << "Next slot reused: " << nova.addLumen(50, 5, 20) << " | After replay: " << recovered.addLumen(50, 5, 20) << std::endl;
+
+    // Assigning a larger nova replaces every slot, so the next checkpoint writes all of them
+    Lumen** larger = new Lumen*[20];
+    nova = Nova(100, 10, 30, 20, larger);
+    std::cout << "Dirty after assign: " << nova.getDirtyCount() << std::endl;
+    journal.checkpoint(nova);
+    Nova assigned = journal.replay();
+    std::cout << "Replay after assign matches: " << (assigned == nova) << std::endl;
+
+    // A smaller nova leaves slots behind that replay has to drop
+    Lumen** smaller = new Lumen*[4];
+    nova = Nova(100, 10, 30, 4, smaller);
+    journal.checkpoint(nova);
+    Nova shrunk = journal.replay();
+    std::cout << "Replay after shrink matches: " << (shrunk == nova) << " | Slots: " << shrunk.getSlotCount() << std::endl;
+    std::remove("nova.journal");
+}
+
+void testNovaRecording() {
+
+    std::cout << "\nTesting WORKLOAD RECORDING..." << std::endl;
+
+    Lumen** lumens = new Lumen*[12];
+    Nova nova(100, 10, 30, 12, lumens);
+    Nova other(nova);
+
+    {
+        WorkloadRecorder recorder("nova.workload");
+        nova.setRecorder(&recorder);
+        nova.glow(6);
+        nova.getMinGlow();
+        nova.getMaxGlow();
+        nova++;
+        nova += other;
+        nova.setRecorder(nullptr);
+        nova.glow(6); // Not recorded
+        std::cout << "Recorded calls: " << recorder.getEventCount() << std::endl;
+    }
+
+    WorkloadReader reader("nova.workload");
+    WorkloadEvent event;
+    while (reader.next(event)) {
+        std::cout << workloadOpName(event.op) << " ";
+    }
+    std::cout << std::endl;
+    std::remove("nova.workload");
+}
+
+void testNovaFingerprints() {
+
+    std::cout << "\nTesting FINGERPRINTS..." << std::endl;
+
+    Lumen** lumens1 = new Lumen*[12];
+    Lumen** lumens2 = new Lumen*[12];
+    Nova nova1(100, 10, 30, 12, lumens1);
+    Nova nova2(100, 10, 30, 12, lumens2);
+
+    std::cout << "Same lumens, same fingerprint: " << (nova1.getFingerprint() == nova2.getFingerprint()) << std::endl;
+    nova2.glow(4);
+    std::cout << "After glow, EQUALITY: " << (nova1 == nova2) << std::endl; // Rejected without scanning
+
+    std::unordered_set<Nova> seen;
+    seen.insert(nova1);
+    seen.insert(nova2);
+    seen.insert(Nova(nova1));
+    std::cout << "Distinct novas: " << seen.size() << std::endl;
+}
+
+void testNovaSimulator() {
+
+    std::cout << "\nTesting EVENT DRIVEN SIMULATOR..." << std::endl;
+
+    Nova stepped;
+    for (int i = 0; i < 200; ++i) {
+        stepped.addLumen((i * 37) % 600, 1 + i % 12, (i * 53) % 700);
+    }
+    Nova simulated(stepped);
+    NovaSimulator simulator(simulated);
+
+    // Running tick by tick and event to event must end in the same state
+    for (int tick = 0; tick < 500; ++tick) {
+        stepped.glow(stepped.getSlotCount());
+    }
+    simulator.advance(500);
+    simulator.sync();
+    std::cout << "States match: " << (stepped == simulated && stepped.getFingerprint() == simulated.getFingerprint())
+              << " | Lumen updates: " << simulator.getProcessedCount() << " of " << 500 * stepped.getLumenCount() << std::endl;
+}
+
+void testNovaThreadPool() {
+
+    std::cout << "\nTesting PARALLEL CONSTRUCTION AND COPY..." << std::endl;
+
+    ThreadPool pool(4);
+    const int count = 100000;
+    Lumen** lumens1 = new Lumen*[count];
+    Lumen** lumens2 = new Lumen*[count];
+    Nova serial(100, 10, 30, count, lumens1);
+    Nova parallel(100, 10, 30, count, lumens2, &pool);
+
+    // The pool only changes who does the work, never the result
+    Nova copy(parallel);
+    Nova assigned;
+    assigned = parallel;
+    std::cout << "Construction matches: " << (serial == parallel && serial.getFingerprint() == parallel.getFingerprint())
+              << " | Copy matches: " << (copy == serial) << " | Assignment matches: " << (assigned == serial)
+              << " | Threads: " << pool.getThreadCount() << std::endl;
+}
+
+void testNovaLazy() {
+
+    std::cout << "\nTesting LAZY NOVA..." << std::endl;
+
+    const int count = 5000;
+    Lumen** lumens = new Lumen*[count];
+    Nova eager(100, 10, 30, count, lumens);
+    Nova lazy = Nova::createLazy(100, 10, 30, count);
+
+    // Only the glowed lumens are allocated, the rest are read from the pattern
+    eager.glow(50);
+    lazy.glow(50);
+    std::cout << "Allocated: " << lazy.getMaterializedCount() << " of " << lazy.getSlotCount()
+              << " | Queries match: " << (eager.getMinGlow() == lazy.getMinGlow() && eager.getMaxGlow() == lazy.getMaxGlow())
+              << " | States match: " << (eager == lazy && eager.getFingerprint() == lazy.getFingerprint()) << std::endl;
+
+    // Appending would allocate every virtual slot first, so only vacant slots can take new lumens
+    bool refused = false;
+    try {
+        lazy.addLumen(50, 5, 20);
+    } catch (const std::invalid_argument&) {
+        refused = true;
+    }
+    lazy.removeLumen(10);
+    std::cout << "Append refused: " << refused << " | Vacant slot reused: " << (lazy.addLumen(50, 5, 20) == 10)
+              << " | Allocated: " << lazy.getMaterializedCount() << std::endl;
+}
+
+void testNovaSpill() {
+
+    std::cout << "\nTesting MEMORY BUDGET..." << std::endl;
+
+    const int count = 40000;
+    Lumen** plainLumens = new Lumen*[count];
+    Lumen** budgetLumens = new Lumen*[count];
+    Nova plain(100, 10, 30, count, plainLumens);
+    Nova budgeted(100, 10, 30, count, budgetLumens);
+    budgeted.setMemoryBudget(plain.getMemoryFootprint() / 2, "p4_spill.tmp");
+
+    // Glowing a prefix keeps it in memory, the cold tail stays on disk and only its summaries are read
+    for (int i = 0; i < 20; i++)
+    {
+        plain.glow(4096);
+        budgeted.glow(4096);
+    }
+    SpillStats stats = budgeted.getSpillStats();
+    std::cout << "Queries match: " << (plain.getMinGlow() == budgeted.getMinGlow() && plain.getMaxGlow() == budgeted.getMaxGlow())
+              << " | Under budget: " << (budgeted.getMemoryFootprint() <= plain.getMemoryFootprint() / 2)
+              << " | Hits: " << stats.hits << " | Misses: " << stats.misses
+              << " | Blocks out: " << stats.blocksEvicted << " | Blocks in: " << stats.blocksLoaded << std::endl;
+    std::cout << "States match: " << (plain == budgeted && plain.getFingerprint() == budgeted.getFingerprint()) << std::endl;
+}
+
+void testNovaShared() {
+
+    std::cout << "\nTesting SHARED MEMORY..." << std::endl;
+
+    const int count = 2000;
+    Lumen** lumens = new Lumen*[count];
+    Nova nova(100, 10, 30, count, lumens);
+    nova.setSharedMemory("/p4_nova");
+
+    // A reader sees the last published state, usually from another process
+    SharedNovaReader reader("/p4_nova");
+    nova.glow(500);
+    nova.removeLumen(7);
+    int staleCount = reader.getLumenCount();
+    nova.publishShared();
+    std::cout << "Lumens before publish: " << staleCount << " | After publish: " << reader.getLumenCount()
+              << " | Queries match: " << (reader.getMinGlow() == nova.getMinGlow() && reader.getMaxGlow() == nova.getMaxGlow())
+              << " | Version: " << reader.getVersion() << std::endl;
+
+    // A move swaps the lumens but not the modes, the segment publishes the moved in lumens and the budget spills the others
+    Lumen** budgetLumens = new Lumen*[count];
+    Nova budgeted(100, 10, 30, count, budgetLumens);
+    long long budget = budgeted.getMemoryFootprint() / 2;
+    budgeted.setMemoryBudget(budget, "p4_shared_spill.tmp");
+    Nova before(nova);
+    nova = std::move(budgeted);
+    nova.publishShared();
+    bool moved = budgeted.getMemoryFootprint() <= budget && budgeted == before && reader.getLumenCount() == count;
+    nova = budgeted; // A copy keeps the segment of nova and takes no budget
+    nova.publishShared();
+
+    // A name in use belongs to its writer, a second one fails instead of truncating the segment under the reader
+    bool taken = false;
+    try {
+        budgeted.setMemoryBudget(0, "");
+        budgeted.setSharedMemory("/p4_nova");
+    } catch (const std::runtime_error&) {
+        taken = true;
+    }
+    std::cout << "Move kept modes: " << moved << " | Copy assigned: " << (nova == budgeted)
+              << " | Name taken: " << taken << " | Reader lumens: " << reader.getLumenCount() << std::endl;
+}
+
+void testNovaCommandQueue() {
+
+    std::cout << "\nTesting COMMAND QUEUE..." << std::endl;
+
+    const int count = 500;
+    const int producers = 4;
+    const int perProducer = 1000;
+    Lumen** lumens = new Lumen*[count];
+    Nova nova(100, 10, 30, count, lumens);
+    nova.setCommandQueue(64);
+    NovaCommandQueue* queue = nova.getCommandQueue();
+
+    // Producers block while the queue is full, the owning thread drains in batches until all of them are done
+    std::vector<std::thread> threads;
+    std::vector<CommandToken> lastTokens(producers);
+    for (int p = 0; p < producers; p++)
+    {
+        threads.push_back(std::thread([queue, p, &lastTokens]() {
+            for (int i = 0; i < perProducer; i++)
+            {
+                NovaCommand command = {i % 10 == 9 ? CMD_RECHARGE : CMD_GLOW, (p * 37 + i) % (count + 1)};
+                lastTokens[p] = queue->push(command);
+            }
+        }));
+    }
+    long long drained = 0;
+    while (drained < producers * perProducer)
+    {
+        drained += nova.drainCommands(256);
+    }
+    for (int p = 0; p < producers; p++)
+    {
+        threads[p].join();
+    }
+
+    bool allDone = true;
+    for (int p = 0; p < producers; p++)
+    {
+        allDone = allDone && queue->isDone(lastTokens[p]);
+    }
+    std::cout << "Applied: " << drained << " | Tokens done: " << allDone << " | Failed: " << queue->getFailedCount()
+              << " | Pending: " << queue->getPendingCount() << std::endl;
+}
+
+void testNovaKernels() {
+
+    std::cout << "\nTesting BULK KERNELS (" << kernelInstructionSet() << ")..." << std::endl;
+
+    // More lumens than a block holds, so whole blocks, a partial block and the vector remainders all run
+    const int count = 1000;
+    Lumen** lumens1 = new Lumen*[count];
+    Lumen** lumens2 = new Lumen*[count];
+    Nova nova1(100, 10, 30, count, lumens1);
+    Nova nova2(100, 10, 30, count, lumens2);
+    Nova original(nova1);
+
+    nova1 += nova2;
+    std::cout << "After +=, GREATER: " << (nova1 > original) << std::endl;
+    nova1 -= nova2;
+    std::cout << "After -= back, EQUALITY: " << (nova1 == original)
+              << " | Same fingerprint: " << (nova1.getFingerprint() == original.getFingerprint()) << std::endl;
+
+    ++nova1;
+    --nova1;
+    std::cout << "After ++ and --, EQUALITY: " << (nova1 == original) << std::endl;
+}
+
+void testLumenPolicies() {
+
+    std::cout << "\nTesting LUMEN POLICIES..." << std::endl;
+
+    // Same lumen on the floating point and the fixed point model, they only part where the products round differently
+    BasicLumen<DefaultLumenPolicy> floating(40, 3, 900);
+    BasicLumen<FixedPointLumenPolicy<> > fixed(40, 3, 900);
+    for (int i = 0; i < 6; i++)
+    {
+        std::cout << "Glow " << i + 1 << ": " << floating.glow() << " | Fixed point: " << fixed.glow() << std::endl;
+    }
+}
+
+void testNovaTick() {
+
+    std::cout << "\nTesting TICK PIPELINE..." << std::endl;
+
+    Lumen** lumens1 = new Lumen*[600];
+    Nova nova1(100, 10, 30, 600, lumens1);
+    Nova nova2 = Nova::createLazy(80, 5, 200, 300);
+    Nova copy1(nova1);
+    Nova copy2(nova2);
+
+    // The first tick counts the inactive lumens, later ones reuse the count the previous tick predicted
+    std::vector<Nova*> novas = {&nova1, &nova2};
+    std::vector<int> minGlows, maxGlows;
+    bool glowsMatch = true;
+    for (int t = 0; t < 40; t++)
+    {
+        Nova::tickAll(novas, minGlows, maxGlows);
+        copy1.glow(copy1.getSlotCount());
+        copy2.glow(copy2.getSlotCount());
+        glowsMatch = glowsMatch && minGlows[0] == copy1.getMinGlow() && maxGlows[0] == copy1.getMaxGlow() &&
+                     minGlows[1] == copy2.getMinGlow() && maxGlows[1] == copy2.getMaxGlow();
+    }
+    std::cout << "Glows match: " << glowsMatch << " | States match: " << (nova1 == copy1 && nova2 == copy2)
+              << " | Glow max value: " << maxGlows[0] << " | Glow min value:" << minGlows[0] << std::endl;
+}
 
 int main(){
   testLumenOperators();
   testNovaOperators();
   testNovaMoveSemantics();
+  testNovaRvalueOperators();
+  testNovaResizing();
+  testNovaCheckpoints();
+  testNovaRecording();
+  testNovaFingerprints();
+  testNovaSimulator();
+  testNovaThreadPool();
+  testNovaLazy();
+  testNovaSpill();
+  testNovaShared();
+  testNovaCommandQueue();
+  testNovaKernels();
+  testLumenPolicies();
+  testNovaTick();
   
 }
\ No newline at end of file
@@ -0,0 +1,347 @@
+/*
+ * checkpoint.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements an append-only checkpoint journal for nova. Each checkpoint appends one frame:
+ *
+ *     header   { magic, full, slotCount, recordCount }
+ *     records  { slot, live, freeOrder, LumenState } * recordCount
+ *     checksum FNV-1a over header and records
+ *
+ * Delta frames only carry the slots the nova marked dirty since the previous checkpoint. Replay keeps the last record
+ * seen for each slot, so rebuilding the nova reads the journal once and allocates each lumen once.
+ *
+ * ASSUMPTIONS:
+ *  1) The journal is read back by a build with the same LumenState layout and byte order.
+ *  2) The first frame of a journal is a full frame, or the nova had every slot dirty when the first delta was written.
+ *  3) A crash while appending can only damage the last frame.
+ *
+*/
+
+#include "checkpoint.h"
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+using namespace std;
+
+namespace
+{
+    const uint32_t FRAME_MAGIC = 0x4B43564E; // "NVCK"
+
+    struct FrameHeader {
+        uint32_t magic;
+        uint32_t full;
+        uint32_t slotCount;
+        uint32_t recordCount;
+    };
+
+    // FNV-1a, continued across calls by passing the previous hash
+    uint32_t checksum(const void* data, size_t length, uint32_t hash)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    const uint32_t CHECKSUM_SEED = 2166136261u;
+}
+
+// Pre-Condition: path names a file that can be created or appended to
+// Post-Condition: The journal refers to path, nothing is written until the first checkpoint
+CheckpointJournal::CheckpointJournal(const std::string& path)
+    : path(path)
+{
+}
+
+// Pre-Condition: nova is the nova this journal was started for
+// Post-Condition: Appends a delta frame with the slots that changed since the last checkpoint and clears them
+void CheckpointJournal::checkpoint(Nova& nova)
+{
+    if (nova.fullFrameDue)
+    {
+        fullCheckpoint(nova); // The state was replaced, slots missing from a delta would keep their old records
+        return;
+    }
+
+    std::vector<CheckpointRecord> records;
+    records.reserve(nova.getDirtyCount());
+    for (size_t i = 0; i < nova.dirtySlots.size(); i++)
+    {
+        records.push_back(makeRecord(nova, nova.dirtySlots[i]));
+    }
+
+    // Virtual slots of a lazy nova are dirty as a block until their first checkpoint
+    if (nova.virtualDirty)
+    {
+        for (int i = nova.numLumens - nova.virtualCount; i < nova.numLumens; i++)
+        {
+            records.push_back(makeRecord(nova, i));
+        }
+    }
+    nova.enforceBudget(); // makeRecord() paged in the spilled blocks it read
+
+    numberFreeSlots(nova, records);
+    writeFrame(false, nova.numLumens, records, path, true);
+    nova.clearDirty();
+}
+
+// Pre-Condition: None
+// Post-Condition: Appends a full frame with every slot of the nova and clears its dirty slots
+void CheckpointJournal::fullCheckpoint(Nova& nova)
+{
+    std::vector<CheckpointRecord> records;
+    records.reserve(nova.numLumens);
+    for (int i = 0; i < nova.numLumens; i++)
+    {
+        records.push_back(makeRecord(nova, i));
+        if ((i + 1) % SpillStore::BLOCK_SLOTS == 0)
+        {
+            nova.enforceBudget(); // Spilled blocks are paged in one at a time
+        }
+    }
+    nova.enforceBudget();
+
+    numberFreeSlots(nova, records);
+    writeFrame(true, nova.numLumens, records, path, true);
+    nova.clearDirty();
+}
+
+// Pre-Condition: None
+// Post-Condition: Replaces the journal with a single full frame holding the latest record of every slot,
+// a damaged last frame is dropped
+void CheckpointJournal::compact()
+{
+    std::vector<CheckpointRecord> latest;
+    int slotCount = readLatest(latest);
+
+    // Vacant slots are kept too, their free list order isn't implied by the full frame
+    std::vector<CheckpointRecord> records(latest.begin(), latest.begin() + slotCount);
+
+    // Write beside the journal and rename over it so a crash leaves either the old or the new journal
+    std::string compacted = path + ".compact";
+    writeFrame(true, slotCount, records, compacted, false);
+    if (std::rename(compacted.c_str(), path.c_str()) != 0)
+    {
+        throw std::runtime_error("Could not replace journal with compacted journal");
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns a nova rebuilt from every complete frame, with no dirty slots
+Nova CheckpointJournal::replay() const
+{
+    std::vector<CheckpointRecord> latest;
+    int slotCount = readLatest(latest);
+
+    Nova nova;
+    nova.reserve(slotCount);
+    nova.numLumens = slotCount;
+    nova.dirtyFlags.assign(slotCount, 0);
+    std::vector<std::pair<int, int> > vacant; // freeOrder and slot of every vacant slot
+    for (int i = 0; i < slotCount; i++)
+    {
+        if (latest[i].live)
+        {
+            nova.lumens[i] = new Lumen(latest[i].state);
+            nova.liveLumens++;
+            nova.accountLumen(i);
+        }
+        else
+        {
+            nova.lumens[i] = nullptr;
+            vacant.push_back(std::make_pair(latest[i].freeOrder, -i));
+        }
+    }
+
+    // Rebuild the free list in its saved order, slots without one go below the rest with the lowest slot on top
+    std::sort(vacant.begin(), vacant.end());
+    for (size_t i = 0; i < vacant.size(); i++)
+    {
+        nova.freeSlots.push_back(-vacant[i].second);
+    }
+    return nova;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the size of the journal in bytes, 0 if it has not been written yet
+long long CheckpointJournal::getJournalSize() const
+{
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in)
+    {
+        return 0;
+    }
+    return (long long)in.tellg();
+}
+
+// Helper method for appending or writing one frame
+// Pre-Condition: records are in slot order or dirty order, every slot is below slotCount
+// Post-Condition: The frame with its checksum is written to target, throws if the file can't be written
+void CheckpointJournal::writeFrame(bool full, int slotCount, const std::vector<CheckpointRecord>& records, const std::string& target, bool append) const
+{
+    ofstream out(target, ios::binary | (append ? ios::app : ios::trunc));
+    if (!out)
+    {
+        throw std::runtime_error("Could not open checkpoint journal for writing");
+    }
+
+    FrameHeader header;
+    header.magic = FRAME_MAGIC;
+    header.full = full ? 1 : 0;
+    header.slotCount = (uint32_t)slotCount;
+    header.recordCount = (uint32_t)records.size();
+
+    uint32_t sum = checksum(&header, sizeof(header), CHECKSUM_SEED);
+    sum = checksum(records.data(), records.size() * sizeof(CheckpointRecord), sum);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CheckpointRecord));
+    out.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+    out.flush();
+    if (!out)
+    {
+        throw std::runtime_error("Could not write checkpoint frame");
+    }
+}
+
+// Helper method for folding the journal
+// Pre-Condition: None
+// Post-Condition: latest holds the last record of every slot from complete frames, returns the slot count
+int CheckpointJournal::readLatest(std::vector<CheckpointRecord>& latest) const
+{
+    latest.clear();
+    int slotCount = 0;
+
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in)
+    {
+        return 0;
+    }
+    long long fileBytes = (long long)in.tellg();
+    in.seekg(0);
+
+    FrameHeader header;
+    std::vector<CheckpointRecord> records;
+    while (in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        if (header.magic != FRAME_MAGIC)
+        {
+            break;
+        }
+
+        // The count isn't checked by the checksum yet, a damaged one must not size the buffer beyond the file
+        long long remaining = fileBytes - (long long)in.tellg() - (long long)sizeof(uint32_t);
+        if (remaining < 0 || header.recordCount > remaining / (long long)sizeof(CheckpointRecord))
+        {
+            break;
+        }
+        records.resize(header.recordCount);
+        uint32_t stored;
+        if (!in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(CheckpointRecord)) ||
+            !in.read(reinterpret_cast<char*>(&stored), sizeof(stored)))
+        {
+            break; // Frame cut short by a crash while appending
+        }
+
+        uint32_t sum = checksum(&header, sizeof(header), CHECKSUM_SEED);
+        sum = checksum(records.data(), records.size() * sizeof(CheckpointRecord), sum);
+        if (sum != stored)
+        {
+            break;
+        }
+
+        // Every frame carries the nova's slot count, an assignment can make it shrink
+        CheckpointRecord vacant = CheckpointRecord();
+        latest.resize(header.slotCount, vacant);
+        slotCount = (int)header.slotCount;
+        if (header.full)
+        {
+            for (int i = 0; i < slotCount; i++)
+            {
+                latest[i].live = 0;
+            }
+        }
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            if (records[i].slot >= 0 && records[i].slot < slotCount)
+            {
+                latest[records[i].slot] = records[i];
+            }
+        }
+    }
+
+    for (int i = 0; i < slotCount; i++)
+    {
+        latest[i].slot = i;
+    }
+    return slotCount;
+}
+
+// Helper method for building a record
+// Pre-Condition: slot is within bounds of nova
+// Post-Condition: Returns the slot's lumen state, virtual slots included, or a vacant record
+CheckpointRecord CheckpointJournal::makeRecord(const Nova& nova, int slot)
+{
+    CheckpointRecord record = CheckpointRecord();
+    record.slot = slot;
+    nova.ensureResident(slot, slot + 1);
+    record.live = nova.isVacant(slot) ? 0 : 1;
+    if (record.live)
+    {
+        record.state = nova.lumenAt(slot).getState();
+    }
+    return record;
+}
+
+// Helper method for saving the free list order
+// Pre-Condition: records were built by makeRecord() from nova
+// Post-Condition: Every vacant record holds its slot's position in the nova's free list
+void CheckpointJournal::numberFreeSlots(const Nova& nova, std::vector<CheckpointRecord>& records)
+{
+    bool anyVacant = false;
+    for (size_t i = 0; i < records.size() && !anyVacant; i++)
+    {
+        anyVacant = records[i].live == 0;
+    }
+    if (!anyVacant)
+    {
+        return;
+    }
+
+    std::unordered_map<int, int> position;
+    for (size_t i = 0; i < nova.freeSlots.size(); i++)
+    {
+        position[nova.freeSlots[i]] = (int)i;
+    }
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        if (records[i].live) continue;
+        std::unordered_map<int, int>::const_iterator found = position.find(records[i].slot);
+        records[i].freeOrder = found != position.end() ? found->second : -1;
+    }
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * Frames are appended with a single stream and flushed before the dirty slots are cleared, so a failed write
+ * leaves the slots dirty for the next checkpoint.
+ * Replay and compaction share readLatest(), which folds frames into one record per slot (last writer wins)
+ * and stops at the first frame with a bad magic, a record count larger than the rest of the file, a short read or a
+ * wrong checksum.
+ * A full frame marks every slot vacant before applying its records, so slots it doesn't list are vacant.
+ * Each frame resizes the folded records to its own slot count, dropping slots a smaller nova no longer has.
+ * checkpoint() writes a full frame instead of a delta when the nova's state was replaced by a copy or assignment.
+ * Compaction writes to a side file and renames it over the journal.
+ * The free list is a stack, so a vacant slot keeps its position in it until it is reused, and both vacating and
+ * reusing a slot mark it dirty. Saving the position with each vacant record is therefore enough for replay to
+ * rebuild the free list in the order the live nova would reuse it.
+ */
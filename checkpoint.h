@@ -0,0 +1,52 @@
+/*
+ * checkpoint.h
+ *
+ * This file creates a class CheckpointJournal that saves the state of a nova to an append-only binary file.
+ * A checkpoint only writes the slots that changed since the previous checkpoint, so its cost follows the number
+ * of changed lumens instead of the size of the nova. The journal can be compacted and replayed to rebuild the nova.
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "nova.h"
+#include <string>
+
+/* Class Invariants:
+    * 1) The journal file is only appended to, except by compact() which replaces it as a whole
+    * 2) Every frame holds a header, its records and a checksum, a frame that is cut short or fails the checksum ends replay
+    * 3) A full frame describes every slot, a delta frame only the slots that changed
+    * 4) Replaying all frames in order rebuilds the nova exactly, including counters, vacant slots and the order
+    *    vacant slots are reused in
+    * 5) Writing a checkpoint clears the nova's dirty slots
+*/
+
+// One slot of a checkpoint frame, live is 0 when the slot is vacant
+struct CheckpointRecord {
+    int slot;
+    int live;
+    int freeOrder; // Position of a vacant slot in the nova's free list, the last one is reused first
+    LumenState state;
+};
+
+class CheckpointJournal
+{
+public:
+    explicit CheckpointJournal(const std::string& path);
+
+    void checkpoint(Nova& nova);
+    void fullCheckpoint(Nova& nova);
+    void compact();
+    Nova replay() const;
+    long long getJournalSize() const;
+
+private:
+    std::string path;
+    void writeFrame(bool full, int slotCount, const std::vector<CheckpointRecord>& records, const std::string& target, bool append) const;
+    int readLatest(std::vector<CheckpointRecord>& latest) const;
+    static CheckpointRecord makeRecord(const Nova& nova, int slot);
+    static void numberFreeSlots(const Nova& nova, std::vector<CheckpointRecord>& records);
+};
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ * commandqueue.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements a bounded multi producer, single consumer queue of nova commands. Each cell of the ring
+ * carries a sequence number. A producer claims a ticket with one compare and swap on the enqueue position, writes
+ * its command into the ticket's cell and publishes it by moving the cell's sequence number on. The consumer reads
+ * cells in ticket order without any atomic read-modify-write and hands each cell back to the producer one lap ahead.
+ * A full queue makes tryPush() fail and push() wait, so producers can't run ahead of the nova by more than the
+ * capacity.
+ *
+ * ASSUMPTIONS:
+ *  1) pop() and complete() are only called from the thread that owns the nova.
+ *  2) Fewer than 2^63 commands go through one queue.
+ *
+*/
+
+#include "commandqueue.h"
+#include <stdexcept>
+#include <thread>
+using namespace std;
+
+// Pre-Condition: capacity is positive
+// Post-Condition: Creates an empty queue of capacity rounded up to a power of two
+NovaCommandQueue::NovaCommandQueue(int capacity)
+    : cells(nullptr), capacity(1), mask(0), enqueuePos(0), dequeuePos(0), completed(0), failed(0)
+{
+    if (capacity <= 0 || capacity > (1 << 30))
+    {
+        throw std::invalid_argument("Queue capacity must be positive!");
+    }
+    while (this->capacity < capacity)
+    {
+        this->capacity *= 2;
+    }
+    mask = this->capacity - 1;
+
+    cells = new Cell[this->capacity];
+    for (int i = 0; i < this->capacity; i++)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Pre-Condition: No thread is using the queue
+// Post-Condition: Frees the ring, queued commands are dropped
+NovaCommandQueue::~NovaCommandQueue()
+{
+    delete[] cells;
+}
+
+// Pre-Condition: None, safe to call from any thread
+// Post-Condition: Returns false without waiting if the queue is full, otherwise queues the command and sets token
+bool NovaCommandQueue::tryPush(const NovaCommand& command, CommandToken& token)
+{
+    long long pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Cell& cell = cells[pos & mask];
+        long long sequence = cell.sequence.load(std::memory_order_acquire);
+        long long diff = sequence - pos;
+        if (diff == 0)
+        {
+            // The cell is free for this ticket, claim the ticket before anyone else does
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.command = command;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                token.ticket = pos;
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // The consumer hasn't freed this cell from the previous lap
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed); // Another producer took the ticket
+        }
+    }
+}
+
+// Pre-Condition: None, safe to call from any thread
+// Post-Condition: Queues the command, waiting while the queue is full, and returns its token
+CommandToken NovaCommandQueue::push(const NovaCommand& command)
+{
+    CommandToken token = CommandToken();
+    int spins = 0;
+    while (!tryPush(command, token))
+    {
+        // Backpressure: spin briefly, then give the consumer the core
+        if (++spins > 64)
+        {
+            std::this_thread::yield();
+        }
+    }
+    return token;
+}
+
+// Pre-Condition: token came from this queue
+// Post-Condition: Returns whether the command has been applied or skipped
+bool NovaCommandQueue::isDone(const CommandToken& token) const
+{
+    return completed.load(std::memory_order_acquire) > token.ticket;
+}
+
+// Pre-Condition: token came from this queue and some thread keeps draining it
+// Post-Condition: Returns once the command has been applied or skipped, its effects are visible to the caller
+void NovaCommandQueue::wait(const CommandToken& token) const
+{
+    int spins = 0;
+    while (!isDone(token))
+    {
+        if (++spins > 64)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Pre-Condition: Called by the consumer only, commands holds maxCommands entries
+// Post-Condition: Moves up to maxCommands queued commands into commands in ticket order and returns how many
+int NovaCommandQueue::pop(NovaCommand* commands, int maxCommands)
+{
+    int count = 0;
+    while (count < maxCommands)
+    {
+        Cell& cell = cells[dequeuePos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+        {
+            break; // Empty, or the producer of the next ticket is still writing
+        }
+        commands[count++] = cell.command;
+        cell.sequence.store(dequeuePos + capacity, std::memory_order_release);
+        dequeuePos++;
+    }
+    return count;
+}
+
+// Pre-Condition: Called by the consumer only, count commands were popped and not completed yet, failed of them threw
+// Post-Condition: Their tokens are done, and whatever applying them changed is visible to threads that see that
+void NovaCommandQueue::complete(int count, int failed)
+{
+    this->failed.fetch_add(failed, std::memory_order_relaxed);
+    completed.store(completed.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of cells in the ring
+int NovaCommandQueue::getCapacity() const
+{
+    return capacity;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the commands queued but not completed yet, a snapshot while producers are running
+long long NovaCommandQueue::getPendingCount() const
+{
+    return enqueuePos.load(std::memory_order_acquire) - completed.load(std::memory_order_acquire);
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of completed commands
+long long NovaCommandQueue::getCompletedCount() const
+{
+    return completed.load(std::memory_order_acquire);
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of completed commands that threw and were skipped
+long long NovaCommandQueue::getFailedCount() const
+{
+    return failed.load(std::memory_order_relaxed);
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * A producer writes a cell's command only after its compare and swap gave it the ticket, and no other producer can
+ * get the same ticket, so commands never overwrite each other. The release store of ticket + 1 publishes the command
+ * to the consumer's acquire load.
+ * The consumer frees a cell with ticket + capacity, which is exactly the ticket of the producer one lap later.
+ * completed only grows and never passes the dequeue position, its release store follows every change the batch made.
+ */
@@ -0,0 +1,78 @@
+/*
+ * commandqueue.h
+ *
+ * This file creates a class NovaCommandQueue, a bounded lock free queue that lets many producer threads hand glow,
+ * recharge and reset commands to the one thread that owns a nova. Producers get a token back for each command and
+ * can check or wait for its completion, the owner drains the queue in batches with Nova::drainCommands().
+ *
+ */
+
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <atomic>
+
+// Commands a producer can queue, the argument is only used by CMD_GLOW
+enum NovaCommandOp
+{
+    CMD_GLOW = 1, // glow(arg)
+    CMD_RECHARGE, // Internal recharge on its own
+    CMD_RESET // Replace the unstable lumens on their own
+};
+
+struct NovaCommand {
+    int op;
+    int arg;
+};
+
+// Position of a command in the queue, commands complete in the order they were queued
+struct CommandToken {
+    long long ticket;
+};
+
+/* Class Invariants:
+    * 1) The capacity is a power of two and never changes
+    * 2) Any number of threads may push, only one thread at a time may pop and complete
+    * 3) A cell's sequence number tells whose turn it is: ticket when free for the producer of ticket, ticket + 1 when
+    *    it holds that producer's command, ticket + capacity once the consumer took it
+    * 4) Commands are popped and completed in ticket order, so a token is done once the completed count passes it
+    * 5) A command that throws when applied is skipped and counted as failed, its token still completes
+*/
+
+class NovaCommandQueue
+{
+public:
+    explicit NovaCommandQueue(int capacity);
+    ~NovaCommandQueue();
+    NovaCommandQueue(const NovaCommandQueue& other) = delete;
+    NovaCommandQueue& operator=(const NovaCommandQueue& other) = delete;
+
+    bool tryPush(const NovaCommand& command, CommandToken& token);
+    CommandToken push(const NovaCommand& command);
+    bool isDone(const CommandToken& token) const;
+    void wait(const CommandToken& token) const;
+
+    int pop(NovaCommand* commands, int maxCommands);
+    void complete(int count, int failed);
+
+    int getCapacity() const;
+    long long getPendingCount() const;
+    long long getCompletedCount() const;
+    long long getFailedCount() const;
+
+private:
+    struct Cell {
+        std::atomic<long long> sequence;
+        NovaCommand command;
+    };
+
+    Cell* cells;
+    int capacity;
+    long long mask;
+    alignas(64) std::atomic<long long> enqueuePos; // Next ticket handed to a producer
+    alignas(64) long long dequeuePos; // Next ticket the consumer takes, only touched by the consumer
+    alignas(64) std::atomic<long long> completed; // Tickets below it are done
+    std::atomic<long long> failed;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * histogram.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements a log-linear latency histogram. The first 128 buckets hold the values 0..127 exactly.
+ * After that every power of two range [2^b, 2^(b+1)) is split into 64 equal buckets, so a bucket is never wider
+ * than 1/64 of the values it holds. Counts live in one flat array so recording is a shift, a subtraction and an
+ * increment.
+ *
+ * ASSUMPTIONS:
+ *  1) Latencies are non-negative, negative values are recorded as 0.
+ *  2) Histograms that are merged were created by this class.
+ *
+*/
+
+#include "histogram.h"
+#include <climits>
+#include <cmath>
+using namespace std;
+
+// Pre-Condition: None
+// Post-Condition: Creates an empty histogram covering every non-negative long long
+LatencyHistogram::LatencyHistogram()
+    : counts(bucketIndex(LLONG_MAX) + 1, 0), totalCount(0), minValue(LLONG_MAX), maxValue(0), sum(0)
+{
+}
+
+// Pre-Condition: None
+// Post-Condition: Counts the value in its bucket and updates min, max and sum
+void LatencyHistogram::record(long long nanos)
+{
+    if (nanos < 0) nanos = 0;
+    counts[bucketIndex(nanos)]++;
+    totalCount++;
+    if (nanos < minValue) minValue = nanos;
+    if (nanos > maxValue) maxValue = nanos;
+    sum += (double)nanos;
+}
+
+// Pre-Condition: None
+// Post-Condition: Adds every count of 'other' to the current histogram
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    if (other.minValue < minValue) minValue = other.minValue;
+    if (other.maxValue > maxValue) maxValue = other.maxValue;
+    sum += other.sum;
+}
+
+// Pre-Condition: None
+// Post-Condition: Histogram is empty again
+void LatencyHistogram::clear()
+{
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        counts[i] = 0;
+    }
+    totalCount = 0;
+    minValue = LLONG_MAX;
+    maxValue = 0;
+    sum = 0;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns how many values were recorded
+long long LatencyHistogram::getCount() const
+{
+    return totalCount;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the smallest recorded value, 0 when empty
+long long LatencyHistogram::getMin() const
+{
+    return totalCount == 0 ? 0 : minValue;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the largest recorded value, 0 when empty
+long long LatencyHistogram::getMax() const
+{
+    return maxValue;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the mean of the recorded values, 0 when empty
+double LatencyHistogram::getMean() const
+{
+    return totalCount == 0 ? 0 : sum / (double)totalCount;
+}
+
+// Pre-Condition: percentile is between 0 and 100
+// Post-Condition: Returns the value at or below which the given percent of the recorded values fall, 0 when empty
+long long LatencyHistogram::getPercentile(double percentile) const
+{
+    if (totalCount == 0)
+    {
+        return 0;
+    }
+    if (percentile < 0) percentile = 0;
+    if (percentile > 100) percentile = 100;
+
+    long long target = (long long)ceil(percentile / 100.0 * (double)totalCount);
+    if (target < 1) target = 1;
+
+    long long seen = 0;
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        seen += counts[i];
+        if (seen >= target)
+        {
+            // The bucket's upper edge can overshoot the largest value actually seen
+            long long value = highestValueAt((int)i);
+            return value < maxValue ? value : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+// Helper method for finding a value's bucket
+// Pre-Condition: value is non-negative
+// Post-Condition: Returns the index of the bucket that holds value
+int LatencyHistogram::bucketIndex(long long value)
+{
+    if (value < SUB_BUCKET_COUNT)
+    {
+        return (int)value;
+    }
+
+    int highestBit = 63 - __builtin_clzll((unsigned long long)value);
+    int shift = highestBit - SUB_BUCKET_BITS + 1;
+    int subBucket = (int)(value >> shift); // In [64, 128)
+    return SUB_BUCKET_COUNT + (shift - 1) * HALF_SUB_BUCKET_COUNT + (subBucket - HALF_SUB_BUCKET_COUNT);
+}
+
+// Helper method for reporting percentiles
+// Pre-Condition: index is a valid bucket index
+// Post-Condition: Returns the largest value that maps to the bucket
+long long LatencyHistogram::highestValueAt(int index)
+{
+    if (index < SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+
+    int shift = (index - SUB_BUCKET_COUNT) / HALF_SUB_BUCKET_COUNT + 1;
+    long long subBucket = (index - SUB_BUCKET_COUNT) % HALF_SUB_BUCKET_COUNT + HALF_SUB_BUCKET_COUNT;
+    long long lowest = subBucket << shift;
+    return lowest + ((1LL << shift) - 1);
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * Bucket index of v >= 128: shift = msb(v) - 6, index = 128 + (shift - 1) * 64 + ((v >> shift) - 64).
+ * highestValueAt() is the inverse of bucketIndex() rounded up to the end of the bucket.
+ * Percentiles walk the buckets once, clamped to the exact maximum.
+ */
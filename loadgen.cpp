@@ -0,0 +1,249 @@
+/*
+ * loadgen.cpp
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This tool drives many novas with an open-loop request stream and reports latency percentiles. Lumen brightness,
+ * size and power are drawn from configurable distributions, requests are a weighted mix of glow(n), getMinGlow()
+ * and getMaxGlow() on a random nova, and arrivals follow a Poisson process at a fixed rate.
+ *
+ * Because arrivals are scheduled ahead of time and don't wait for earlier requests to finish, a slow request delays
+ * the ones behind it and that delay shows up in their latency. Latency is measured from the scheduled arrival, the
+ * time spent inside the call alone is reported separately as service time.
+ *
+ * Usage:
+ *     loadgen [--novas N] [--lumens N] [--requests N] [--rate R] [--seed S]
+ *             [--glow W] [--min W] [--max W] [--glow-fraction F]
+ *             [--brightness DIST] [--size DIST] [--power DIST]
+ *
+ *     DIST is one of constant:v, uniform:lo:hi, normal:mean:stddev, exponential:mean, lognormal:mu:sigma
+ *     --rate 0 issues requests back to back (closed loop)
+ *
+ */
+
+#include "nova.h"
+#include "histogram.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Distribution of one lumen parameter, parsed from "kind:a:b"
+struct ParameterDistribution
+{
+    string kind;
+    double a;
+    double b;
+
+    // Pre-Condition: spec is one of the DIST forms in the usage text
+    // Post-Condition: Throws if the kind is unknown or an argument is missing
+    explicit ParameterDistribution(const string& spec)
+        : a(0), b(0)
+    {
+        stringstream in(spec);
+        getline(in, kind, ':');
+        string field;
+        int count = 0;
+        while (getline(in, field, ':'))
+        {
+            (count == 0 ? a : b) = atof(field.c_str());
+            count++;
+        }
+
+        int expected = (kind == "constant" || kind == "exponential") ? 1 : 2;
+        if (kind != "constant" && kind != "uniform" && kind != "normal" && kind != "exponential" && kind != "lognormal")
+        {
+            throw std::invalid_argument("Unknown distribution: " + spec);
+        }
+        if (count != expected)
+        {
+            throw std::invalid_argument("Wrong number of arguments for distribution: " + spec);
+        }
+    }
+
+    // Pre-Condition: None
+    // Post-Condition: Returns a sample rounded to an int and clamped to at least minimum
+    int sample(mt19937& random, int minimum) const
+    {
+        double value;
+        if (kind == "constant") value = a;
+        else if (kind == "uniform") value = uniform_real_distribution<double>(a, b)(random);
+        else if (kind == "normal") value = normal_distribution<double>(a, b)(random);
+        else if (kind == "exponential") value = exponential_distribution<double>(1.0 / a)(random);
+        else value = lognormal_distribution<double>(a, b)(random);
+
+        if (value > 1e9) value = 1e9;
+        int rounded = (int)llround(value);
+        return rounded < minimum ? minimum : rounded;
+    }
+};
+
+struct LoadOptions
+{
+    int novas = 16;
+    int lumens = 1000;
+    long long requests = 100000;
+    double rate = 50000;
+    unsigned int seed = 1;
+    double glowWeight = 0.6;
+    double minWeight = 0.2;
+    double maxWeight = 0.2;
+    double glowFraction = 1.0; // Largest n for glow(n), as a fraction of the nova's slots
+    string brightness = "uniform:1:600";
+    string size = "lognormal:2:0.5";
+    string power = "normal:200:80";
+};
+
+// Reads --name value pairs into options, throws on an unknown name
+LoadOptions parseOptions(int argc, char** argv)
+{
+    LoadOptions options;
+    for (int i = 1; i < argc; i += 2)
+    {
+        string name = argv[i];
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("Missing value for " + name);
+        }
+        string value = argv[i + 1];
+
+        if (name == "--novas") options.novas = atoi(value.c_str());
+        else if (name == "--lumens") options.lumens = atoi(value.c_str());
+        else if (name == "--requests") options.requests = atoll(value.c_str());
+        else if (name == "--rate") options.rate = atof(value.c_str());
+        else if (name == "--seed") options.seed = (unsigned int)atol(value.c_str());
+        else if (name == "--glow") options.glowWeight = atof(value.c_str());
+        else if (name == "--min") options.minWeight = atof(value.c_str());
+        else if (name == "--max") options.maxWeight = atof(value.c_str());
+        else if (name == "--glow-fraction") options.glowFraction = atof(value.c_str());
+        else if (name == "--brightness") options.brightness = value;
+        else if (name == "--size") options.size = value;
+        else if (name == "--power") options.power = value;
+        else throw std::invalid_argument("Unknown option " + name);
+    }
+
+    if (options.novas <= 0 || options.lumens <= 0 || options.requests <= 0 || options.rate < 0)
+    {
+        throw std::invalid_argument("Counts must be positive and rate non-negative");
+    }
+    if (options.glowWeight < 0 || options.minWeight < 0 || options.maxWeight < 0 ||
+        options.glowWeight + options.minWeight + options.maxWeight <= 0)
+    {
+        throw std::invalid_argument("Weights must be non-negative and not all 0");
+    }
+    if (options.glowFraction < 0 || options.glowFraction > 1)
+    {
+        throw std::invalid_argument("Glow fraction must be between 0 and 1");
+    }
+    return options;
+}
+
+void printRow(const string& name, const LatencyHistogram& h)
+{
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::setw(10) << h.getCount() << std::setw(12) << h.getPercentile(50)
+              << std::setw(12) << h.getPercentile(99) << std::setw(12) << h.getPercentile(99.9)
+              << std::setw(12) << h.getMax() << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        LoadOptions options = parseOptions(argc, argv);
+        ParameterDistribution brightness(options.brightness);
+        ParameterDistribution size(options.size);
+        ParameterDistribution power(options.power);
+        mt19937 random(options.seed);
+
+        // Build the novas from the distributions instead of the constructor's fixed pattern
+        std::vector<Nova> novas(options.novas);
+        for (int n = 0; n < options.novas; n++)
+        {
+            novas[n].reserve(options.lumens);
+            for (int i = 0; i < options.lumens; i++)
+            {
+                novas[n].addLumen(brightness.sample(random, 0), size.sample(random, 1), power.sample(random, 0));
+            }
+        }
+
+        enum { GLOW, MIN_GLOW, MAX_GLOW };
+        discrete_distribution<int> pickOp({ options.glowWeight, options.minWeight, options.maxWeight });
+        uniform_int_distribution<int> pickNova(0, options.novas - 1);
+        uniform_int_distribution<int> pickGlowCount(0, (int)(options.lumens * options.glowFraction));
+        exponential_distribution<double> gap(options.rate > 0 ? options.rate : 1.0);
+
+        LatencyHistogram latency[3];
+        LatencyHistogram service[3];
+        const char* names[3] = { "glow", "getMinGlow", "getMaxGlow" };
+        volatile int sink = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        chrono::steady_clock::time_point scheduled = start;
+        for (long long r = 0; r < options.requests; r++)
+        {
+            int op = pickOp(random);
+            Nova& nova = novas[pickNova(random)];
+            int glowCount = pickGlowCount(random);
+
+            // Open loop: the next arrival is fixed by the schedule, not by when the previous request finished
+            if (options.rate > 0)
+            {
+                scheduled += chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(gap(random)));
+                while (chrono::steady_clock::now() < scheduled)
+                {
+                    if (scheduled - chrono::steady_clock::now() > chrono::microseconds(200))
+                    {
+                        std::this_thread::sleep_for(chrono::microseconds(100));
+                    }
+                }
+            }
+
+            chrono::steady_clock::time_point before = chrono::steady_clock::now();
+            if (options.rate <= 0) scheduled = before;
+            if (op == GLOW) nova.glow(glowCount);
+            else if (op == MIN_GLOW) sink = nova.getMinGlow();
+            else sink = nova.getMaxGlow();
+            chrono::steady_clock::time_point after = chrono::steady_clock::now();
+
+            latency[op].record(chrono::duration_cast<chrono::nanoseconds>(after - scheduled).count());
+            service[op].record(chrono::duration_cast<chrono::nanoseconds>(after - before).count());
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        (void)sink;
+
+        std::cout << options.requests << " requests on " << options.novas << " novas of " << options.lumens
+                  << " lumens in " << seconds << " s, achieved " << options.requests / seconds << " req/s";
+        if (options.rate > 0) std::cout << " (target " << options.rate << ")";
+        std::cout << std::endl;
+
+        std::cout << std::left << std::setw(22) << "latency (ns)" << std::right << std::setw(10) << "count"
+                  << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "p99.9" << std::setw(12) << "max" << std::endl;
+        LatencyHistogram all;
+        for (int op = 0; op < 3; op++)
+        {
+            if (latency[op].getCount() > 0) printRow(names[op], latency[op]);
+            all.merge(latency[op]);
+        }
+        printRow("all", all);
+        for (int op = 0; op < 3; op++)
+        {
+            if (service[op].getCount() > 0) printRow(string(names[op]) + " service", service[op]);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "loadgen: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
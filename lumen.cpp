@@ -4,7 +4,13 @@
  * Date: 4/14/2023
  * Revision History: 4/4/2023 -- finished documentation, 4/14/2023 -- added recharge functionality, 
  * added glowQuery functionality, added getUnstableCount functionality, also made pre and post conditions more readable by putting
- * them outside of functions (CORRECTION FROM P1)
+ * them outside of functions (CORRECTION FROM P1), 10/18/2026 -- added LumenState save and restore for checkpoints,
+ * 10/18/2026 -- added brightness, size and power getters for nova fingerprints,
+ * 10/18/2026 -- added glow state and glow kernels without the glow value for partitioned novas,
+ * 10/18/2026 -- added glow state prediction and fast forward for the event driven simulator,
+ * 10/18/2026 -- added getValues() and setValues() for nova's bulk operator kernels,
+ * 10/18/2026 -- made Lumen the BasicLumen template of a decay and threshold policy,
+ * 10/19/2026 -- removed the glow kernels of the partitioned layout, which was dropped from Nova
  * 
  * Platform: Windows
  * 
@@ -33,30 +39,67 @@ using namespace std;
 // Constructor
 // Pre-Condition: If any values are negative, throw an exception printing to the client that values inputted must not be negative.
 // Post-Condition: values for each properties are set. Lumen is initially active.
-Lumen::Lumen(int b, int s, int p)
-    : originalBrightness(b), originalPower(p), brightness(b), size(s), power(p), isActive(true), glowCount(0), unstableCount(0)
+template <class Policy>
+BasicLumen<Policy>::BasicLumen(int b, int s, int p)
+    : originalBrightness(b), originalPower(p), brightness(b), size(s), power(p), isActive(true), glowCount(0), unstableCount(0), resetCount(0)
 {
     if (p < 0 || b < 0 || s <= 0)
     {
         throw std::invalid_argument("Values must be non-negative!");
     }
 
-    POWER_THRESHOLD = (int)(originalPower * 0.4 / size);
-    STABLE_THRESHOLD = (int)(originalPower * 0.5 / size);
-    DIMNESS_VALUE = (int)(originalPower * 0.21 - POWER_THRESHOLD * 0.01 - brightness * size * 0.001);
-    maxReset = size*3;
+    POWER_THRESHOLD = Policy::powerThreshold(originalPower, size);
+    STABLE_THRESHOLD = Policy::stableThreshold(originalPower, size);
+    DIMNESS_VALUE = Policy::dimnessValue(originalPower, POWER_THRESHOLD, brightness, size);
+    maxReset = size * Policy::RESETS_PER_SIZE;
 }
 
-Lumen::Lumen()
-    : originalBrightness(0), originalPower(0), brightness(0), size(0), power(0), isActive(false), glowCount(0), unstableCount(0), POWER_THRESHOLD(0), STABLE_THRESHOLD(0), DIMNESS_VALUE(0), maxReset(0)
+template <class Policy>
+BasicLumen<Policy>::BasicLumen()
+    : originalBrightness(0), originalPower(0), brightness(0), size(0), power(0), isActive(false), glowCount(0), unstableCount(0), POWER_THRESHOLD(0), STABLE_THRESHOLD(0), DIMNESS_VALUE(0), maxReset(0), resetCount(0)
 {
 }
 
+// Restores a lumen saved with getState()
+// Pre-Condition: state was produced by getState()
+// Post-Condition: every field, including counters and thresholds, matches the saved lumen
+template <class Policy>
+BasicLumen<Policy>::BasicLumen(const LumenState& state)
+    : originalBrightness(state.originalBrightness), originalPower(state.originalPower), brightness(state.brightness), size(state.size),
+      power(state.power), glowCount(state.glowCount), unstableCount(state.unstableCount), isActive(state.isActive != 0),
+      maxReset(state.maxReset), resetCount(state.resetCount), POWER_THRESHOLD(state.powerThreshold),
+      STABLE_THRESHOLD(state.stableThreshold), DIMNESS_VALUE(state.dimnessValue)
+{
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns a copy of every field without changing the lumen
+template <class Policy>
+LumenState BasicLumen<Policy>::getState() const
+{
+    LumenState state;
+    state.originalBrightness = originalBrightness;
+    state.originalPower = originalPower;
+    state.brightness = brightness;
+    state.size = size;
+    state.power = power;
+    state.glowCount = glowCount;
+    state.unstableCount = unstableCount;
+    state.isActive = isActive ? 1 : 0;
+    state.maxReset = maxReset;
+    state.resetCount = resetCount;
+    state.powerThreshold = POWER_THRESHOLD;
+    state.stableThreshold = STABLE_THRESHOLD;
+    state.dimnessValue = DIMNESS_VALUE;
+    return state;
+}
+
 
 // Glow method
 // Pre-Conditon: None
 // Post-Condition: glow value is returned depending on the state of the lumen object
-int Lumen::glow()
+template <class Policy>
+int BasicLumen<Policy>::glow()
 {
     glowCount++;
     int glowValue = calculateGlowValue();
@@ -66,9 +109,10 @@ int Lumen::glow()
 // Reset method
 // Pre-Condtion: None
 // Post-Condition: Reverts the objects state to original if valid, else decrease brightness
-bool Lumen::reset()
+template <class Policy>
+bool BasicLumen<Policy>::reset()
 {
-    if (glowCount >= RESET_THRESHOLD && power > 0)
+    if (glowCount >= Policy::RESET_THRESHOLD && power > 0)
     {
         if(resetCount >= maxReset) return false;
         resetOriginal();
@@ -84,7 +128,8 @@ bool Lumen::reset()
 // Getter to get persistently unstable lumens
 // Pre-Condition: None
 // Post-Condtion: Returns a count of how many times lumen is unstable
-int Lumen::getUnstableCount()
+template <class Policy>
+int BasicLumen<Policy>::getUnstableCount()
 {
     return unstableCount;
 }
@@ -92,12 +137,13 @@ int Lumen::getUnstableCount()
 // Simulates the glow but doesn't change the state
 // Pre-Condtion: None
 // Post-Condition: Returns glow value but doesn't change the state of the object
-int Lumen::glowQuery() {
+template <class Policy>
+int BasicLumen<Policy>::glowQuery() {
     
     int tempPower = power;
     bool tempIsActive = isActive;
 
-    tempPower -= (int)(0.35 * tempPower);
+    tempPower -= Policy::decay(tempPower);
     if (tempPower < POWER_THRESHOLD) tempIsActive = false;
 
     if (!tempIsActive) {
@@ -112,7 +158,8 @@ int Lumen::glowQuery() {
 // Helper method for resetting to original state
 // Pre-Condition: None
 // Post-Condition: set objects state back to its original form
-void Lumen::resetOriginal()
+template <class Policy>
+void BasicLumen<Policy>::resetOriginal()
 {
     resetCount += 1;
     brightness = originalBrightness;
@@ -124,15 +171,17 @@ void Lumen::resetOriginal()
 // Helper method for decreasing brightness after invalid reset
 // Pre-Condition: None
 // Post-Condition: Decrement brightness by 10% of its value
-void Lumen::changeBrightness()
+template <class Policy>
+void BasicLumen<Policy>::changeBrightness()
 {
-    brightness -= (int)(0.1 * brightness);
+    brightness -= Policy::fade(brightness);
 }
 
 // Helper method for getting erratic power value
 // Pre-Condition: None
 // Post-Conditon: returns a random number associated with the power of the object using its power brightness and size
-int Lumen::getErraticPower()
+template <class Policy>
+int BasicLumen<Policy>::getErraticPower()
 {
     return power * brightness / size;
 }
@@ -140,7 +189,8 @@ int Lumen::getErraticPower()
 // Helper method for checking stability
 // Pre-Conditon: None
 // Post-Condition: returns if object is stable or unstable by boolean value
-bool Lumen::isStable()
+template <class Policy>
+bool BasicLumen<Policy>::isStable()
 {
     return power > STABLE_THRESHOLD && power > POWER_THRESHOLD; // Make it single line (CORRECTION FROM P1)
 
@@ -154,9 +204,10 @@ bool Lumen::isStable()
 */
 // Pre-Condition: None
 // Post-condition: returns a glow value associated with state of lumen object
-int Lumen::calculateGlowValue()
+template <class Policy>
+int BasicLumen<Policy>::calculateGlowValue()
 {
-    power -= (int)(0.35 * power);
+    power -= Policy::decay(power);
     if(power < POWER_THRESHOLD) isActive= false;
 
     if(!isActive)
@@ -176,14 +227,123 @@ int Lumen::calculateGlowValue()
     }
 }
 
-bool Lumen::getActive()
+template <class Policy>
+bool BasicLumen<Policy>::getActive()
 {
     return isActive;
 }
 
+// Pre-Condition: None
+// Post-Condition: Returns a LumenGlowState, the state calculateGlowValue() would branch on
+template <class Policy>
+int BasicLumen<Policy>::getGlowState() const
+{
+    int stable = power > STABLE_THRESHOLD && power > POWER_THRESHOLD;
+    return (isActive ? 1 : 0) | (stable << 1);
+}
+
+// Predicts the glow state without changing the lumen
+// Pre-Condition: None
+// Post-Condition: Returns how many glows from now the glow state first changes, -1 if power settles without a change
+template <class Policy>
+int BasicLumen<Policy>::glowsUntilStateChange() const
+{
+    int state = getGlowState();
+    int tempPower = power;
+    int tempActive = isActive;
+    for (int glows = 1; ; glows++)
+    {
+        int decay = Policy::decay(tempPower);
+        tempPower -= decay;
+        tempActive &= tempPower >= POWER_THRESHOLD;
+        int stable = (tempPower > STABLE_THRESHOLD) & (tempPower > POWER_THRESHOLD);
+        if ((tempActive | (stable << 1)) != state) return glows;
+        if (decay == 0) return -1; // Power stopped moving, every later glow ends in the same state
+    }
+}
+
+// Glows many times at once
+// Pre-Condition: glows is less than glowsUntilStateChange(), or that returned -1
+// Post-Condition: Same state change as calling glow() glows times, counters wrap like they would there
+template <class Policy>
+void BasicLumen<Policy>::fastForward(long long glows)
+{
+    glowCount = (int)(glowCount + glows);
+    if (getGlowState() != LUMEN_STABLE)
+    {
+        unstableCount = (int)(unstableCount + glows);
+    }
+
+    // Decay shrinks power by about a third each glow, so it reaches its fixed point in a few dozen steps
+    for (long long i = 0; i < glows; i++)
+    {
+        int decay = Policy::decay(power);
+        if (decay == 0) break;
+        power -= decay;
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns true if reset() would change nothing now and after any number of glows that keep the glow state
+template <class Policy>
+bool BasicLumen<Policy>::resetIsNoOp() const
+{
+    // Positive power stays positive while decaying, so only the reset budget decides
+    if (power > 0)
+    {
+        return glowCount >= Policy::RESET_THRESHOLD && resetCount >= maxReset;
+    }
+    return Policy::fade(brightness) == 0;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the current brightness
+template <class Policy>
+int BasicLumen<Policy>::getBrightness() const
+{
+    return brightness;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the current size
+template <class Policy>
+int BasicLumen<Policy>::getSize() const
+{
+    return size;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the current power
+template <class Policy>
+int BasicLumen<Policy>::getPower() const
+{
+    return power;
+}
+
+// Pre-Condition: None
+// Post-Condition: Copies brightness, size and power out in one call
+template <class Policy>
+void BasicLumen<Policy>::getValues(int& b, int& s, int& p) const
+{
+    b = brightness;
+    s = size;
+    p = power;
+}
+
+// Pre-Condition: The values came from a bulk kernel doing what one of the operators does
+// Post-Condition: Sets brightness, size and power the way operator= does, thresholds and counters are unchanged
+template <class Policy>
+void BasicLumen<Policy>::setValues(int b, int s, int p)
+{
+    brightness = b;
+    size = s;
+    power = p;
+}
+
 // Pre-Condition: None
 // Post-Condition: Multiplies power by 6
-void Lumen::recharge()
+template <class Policy>
+void BasicLumen<Policy>::recharge()
 {
     if(isStable()){
         power = originalPower;
@@ -196,7 +356,8 @@ void Lumen::recharge()
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Copies the properties of 'other' to the current lumen object
-Lumen& Lumen::operator=(const Lumen& other) {
+template <class Policy>
+BasicLumen<Policy>& BasicLumen<Policy>::operator=(const BasicLumen& other) {
     if(this != &other) {
         brightness = other.brightness;
         size = other.size;
@@ -207,21 +368,24 @@ Lumen& Lumen::operator=(const Lumen& other) {
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Returns a new 'Lumen' object with the sum of the properties of the current and 'other' lumen objects
-Lumen Lumen::operator+(const Lumen& other) const 
+template <class Policy>
+BasicLumen<Policy> BasicLumen<Policy>::operator+(const BasicLumen& other) const 
 {
-     return Lumen(brightness + other.brightness, size + other.size, power + other.power); 
+     return BasicLumen(brightness + other.brightness, size + other.size, power + other.power); 
 
 }
 
 // Pre-Condition: None
 // Post-Condition: Returns a new 'Lumen' object with the sum of the current lumen object's properties and the specified value
-Lumen Lumen::operator+(int value) const {
-    return Lumen(brightness + value, size, power + value);
+template <class Policy>
+BasicLumen<Policy> BasicLumen<Policy>::operator+(int value) const {
+    return BasicLumen(brightness + value, size, power + value);
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Adds the properties of 'other' to the current lumen object
-Lumen& Lumen::operator+=(const Lumen& other) {
+template <class Policy>
+BasicLumen<Policy>& BasicLumen<Policy>::operator+=(const BasicLumen& other) {
     brightness += other.brightness;
     size += other.size;
     power += other.power;
@@ -230,7 +394,8 @@ Lumen& Lumen::operator+=(const Lumen& other) {
 
 // Pre-Condition: None
 // Post-Condition: Increments the brightness, size, and power of the current lumen object
-Lumen& Lumen::operator++() {
+template <class Policy>
+BasicLumen<Policy>& BasicLumen<Policy>::operator++() {
     ++brightness;
     ++size;
     ++power;
@@ -239,15 +404,17 @@ Lumen& Lumen::operator++() {
 
 // Pre-Condition: None
 // Post-Condition: Increments the brightness, size, and power of the current lumen object (postfix)
-Lumen Lumen::operator++(int) {
-    Lumen copy(*this);
+template <class Policy>
+BasicLumen<Policy> BasicLumen<Policy>::operator++(int) {
+    BasicLumen copy(*this);
     ++(*this);
     return copy;
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Returns true if the current lumen object is equal to 'other', false otherwise
-bool Lumen::operator==(const Lumen& other) const 
+template <class Policy>
+bool BasicLumen<Policy>::operator==(const BasicLumen& other) const 
 { 
     return brightness == other.brightness && size == other.size && power == other.power; 
     
@@ -255,7 +422,8 @@ bool Lumen::operator==(const Lumen& other) const
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Returns true if the current lumen object is not equal to 'other', false otherwise
-bool Lumen::operator!=(const Lumen& other) const 
+template <class Policy>
+bool BasicLumen<Policy>::operator!=(const BasicLumen& other) const 
 { 
     return !(*this == other); 
 
@@ -263,7 +431,8 @@ bool Lumen::operator!=(const Lumen& other) const
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Returns true if the current lumen object is greater than 'other', false otherwise
-bool Lumen::operator>(const Lumen& other) const 
+template <class Policy>
+bool BasicLumen<Policy>::operator>(const BasicLumen& other) const 
 { 
     return brightness > other.brightness && size > other.size && power > other.power; 
 
@@ -271,24 +440,27 @@ bool Lumen::operator>(const Lumen& other) const
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Returns true if the current lumen object is less than 'other', false otherwise
-bool Lumen::operator<(const Lumen& other) const {
+template <class Policy>
+bool BasicLumen<Policy>::operator<(const BasicLumen& other) const {
      return brightness < other.brightness && size < other.size && power < other.power; 
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Returns a new 'Lumen' object with the difference of the properties of the current and 'other' lumen objects
-Lumen Lumen::operator-(const Lumen& other) const 
+template <class Policy>
+BasicLumen<Policy> BasicLumen<Policy>::operator-(const BasicLumen& other) const 
 { 
     int newBrightness = brightness - other.brightness > 0 ? brightness - other.brightness : 0;
     int newSize = size - other.size > 0 ? size - other.size : 0;
     int newPower = power - other.power > 0 ? power - other.power : 0;
 
-    return Lumen(newBrightness, newSize, newPower); 
+    return BasicLumen(newBrightness, newSize, newPower); 
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Lumen' object
 // Post-Condition: Subtracts the properties of 'other' from the current lumen object
-Lumen& Lumen::operator-=(const Lumen& other) {
+template <class Policy>
+BasicLumen<Policy>& BasicLumen<Policy>::operator-=(const BasicLumen& other) {
     brightness -= other.brightness;
     size -= other.size;
     power -= other.power;
@@ -297,7 +469,8 @@ Lumen& Lumen::operator-=(const Lumen& other) {
 
 // Pre-Condition: None
 // Post-Condition: Decrements the brightness, size, and power of the current lumen object
-Lumen& Lumen::operator--() {
+template <class Policy>
+BasicLumen<Policy>& BasicLumen<Policy>::operator--() {
     --brightness;
     --size;
     --power;
@@ -306,12 +479,17 @@ Lumen& Lumen::operator--() {
 
 // Pre-Condition: None
 // Post-Condition: Decrements the brightness, size, and power of the current lumen object (postfix)
-Lumen Lumen::operator--(int) {
-    Lumen copy(*this);
+template <class Policy>
+BasicLumen<Policy> BasicLumen<Policy>::operator--(int) {
+    BasicLumen copy(*this);
     --(*this);
     return copy;
 }
 
+// The policies lumens are built with, a new policy is added here
+template class BasicLumen<DefaultLumenPolicy>;
+template class BasicLumen<FixedPointLumenPolicy<> >;
+
 /*
  * IMPLEMENTATION INVARIANTS: 
  * 
@@ -322,9 +500,12 @@ Lumen Lumen::operator--(int) {
  * Calculate the glow value in seperate function and call it in the glow() function
  * Reset only works if glow has been called at least 5 times
  * glowQuery() doesn't change state and just simulates glow()
+ * glowsUntilStateChange() replays the decay on copies, it stops once power reaches its fixed point
  * Support addition for both types, including
     a. standard addition
     b. mixed-mode addition
     c. ++
     d. short-cut assignment
+ * Every constant of the model is read through Policy, the members are defined here and instantiated below for each
+ * policy the program uses
  */
\ No newline at end of file
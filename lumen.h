@@ -4,6 +4,9 @@
  * This file creates a class Lumen, that has properties such as power, brightness and size.
  * This program demonstrates the use of encapsulation to hide internal state and provides methods to interact with those states,
  * it simply encapsulates state and behavior to provide better resuability.
+ * The decay, thresholds and reset rules come from a policy class given as a template argument, Lumen is the lumen of
+ * the policy picked by LUMEN_POLICY and every nova is built from it. The policy is a build time switch: all novas of a
+ * program share one policy, a BasicLumen of any other policy can only be used on its own.
  * 
  */
 #ifndef LUMEN_H
@@ -25,9 +28,82 @@
         b. mixed-mode addition
         c. ++
         d. short-cut assignment
+    * 12) LumenState holds every field by value so a lumen can be saved and rebuilt exactly
+    * 13) The glow state combines the active flag and stability
+    * 14) glowsUntilStateChange() predicts when glowing changes the glow state, fastForward() applies the glows before
+    *     that point in one step
+    * 15) A policy only holds static constants and static functions, so a lumen stores no more than its fields and
+    *     calls into its policy are resolved and inlined at compile time
+    * 16) DefaultLumenPolicy computes exactly what Lumen always has, FixedPointLumenPolicy uses integer math only
 */
 
-class Lumen {
+// Glow state of a lumen, bit 0 is isActive and bit 1 is isStable()
+enum LumenGlowState
+{
+    LUMEN_INACTIVE = 0, // Inactive with power at or below its thresholds, glowing only counts and decays
+    LUMEN_ERRATIC = 1,  // Active but unstable
+    LUMEN_DORMANT = 2,  // Inactive with stable power, only reachable through the operators
+    LUMEN_STABLE = 3,   // Active and stable
+    LUMEN_STATE_COUNT = 4
+};
+
+// Plain copy of a lumen's fields, used for binary checkpoints
+struct LumenState {
+    int originalBrightness;
+    int originalPower;
+    int brightness;
+    int size;
+    int power;
+    int glowCount;
+    int unstableCount;
+    int isActive;
+    int maxReset;
+    int resetCount;
+    int powerThreshold;
+    int stableThreshold;
+    int dimnessValue;
+};
+
+// The original lumen model, glow decays power by 35% in floating point
+struct DefaultLumenPolicy {
+    static const int RESET_THRESHOLD = 5; // Glows before a reset can restore the original values
+    static const int RESETS_PER_SIZE = 3; // maxReset is size times this
+
+    static int decay(int power) { return (int)(0.35 * power); }
+    static int powerThreshold(int originalPower, int size) { return (int)(originalPower * 0.4 / size); }
+    static int stableThreshold(int originalPower, int size) { return (int)(originalPower * 0.5 / size); }
+    static int dimnessValue(int originalPower, int powerThreshold, int brightness, int size)
+    {
+        return (int)(originalPower * 0.21 - powerThreshold * 0.01 - brightness * size * 0.001);
+    }
+    static int fade(int brightness) { return (int)(0.1 * brightness); }
+};
+
+// Integer lumen model, decay is DECAY_Q16 / 65536 of power and the ratios are in percent. Results round toward zero
+// like the casts of DefaultLumenPolicy but can differ from it by one where the floating point product is inexact
+template <int DECAY_Q16 = 22938, int POWER_PERCENT = 40, int STABLE_PERCENT = 50, int RESET_GLOWS = 5>
+struct FixedPointLumenPolicy {
+    static const int RESET_THRESHOLD = RESET_GLOWS;
+    static const int RESETS_PER_SIZE = 3;
+
+    static int decay(int power) { return (int)((long long)power * DECAY_Q16 / 65536); }
+    static int powerThreshold(int originalPower, int size) { return (int)((long long)originalPower * POWER_PERCENT / (100LL * size)); }
+    static int stableThreshold(int originalPower, int size) { return (int)((long long)originalPower * STABLE_PERCENT / (100LL * size)); }
+    static int dimnessValue(int originalPower, int powerThreshold, int brightness, int size)
+    {
+        return (int)(((long long)originalPower * 210 - (long long)powerThreshold * 10 - (long long)brightness * size) / 1000);
+    }
+    static int fade(int brightness) { return brightness / 10; }
+};
+
+// Build with -DLUMEN_POLICY=... to run every nova on another model, the policy needs an explicit instantiation in
+// lumen.cpp. Nova isn't a template, so one binary can't hold novas of two policies
+#ifndef LUMEN_POLICY
+#define LUMEN_POLICY DefaultLumenPolicy
+#endif
+
+template <class Policy>
+class BasicLumen {
     int originalBrightness;
     int originalPower;
     int brightness;
@@ -36,7 +112,6 @@ class Lumen {
     int glowCount;
     int unstableCount;
     bool isActive;
-    const int RESET_THRESHOLD = 5;
     int maxReset;
     int resetCount;
     int POWER_THRESHOLD;
@@ -44,9 +119,12 @@ class Lumen {
     int DIMNESS_VALUE;
 
 public:
+    typedef Policy PolicyType;
+
     // Constructor
-    Lumen(int b, int s, int p);
-    Lumen();
+    BasicLumen(int b, int s, int p);
+    BasicLumen();
+    explicit BasicLumen(const LumenState& state);
     // Method prototypes
     int glow();
     bool reset();
@@ -55,23 +133,33 @@ public:
     bool getActive();
     void recharge();
     bool isStable();
+    LumenState getState() const;
+    int getGlowState() const;
+    int glowsUntilStateChange() const;
+    void fastForward(long long glows);
+    bool resetIsNoOp() const;
+    int getBrightness() const;
+    int getSize() const;
+    int getPower() const;
+    void getValues(int& b, int& s, int& p) const;
+    void setValues(int b, int s, int p);
 
     // Overloaded operators
-    Lumen& operator=(const Lumen& other);
-    Lumen operator+(const Lumen& other) const;
-    Lumen operator+(int value) const;
-
-    Lumen& operator+=(const Lumen& other);
-    Lumen& operator++();
-    Lumen operator++(int);
-    bool operator==(const Lumen& other) const;
-    bool operator!=(const Lumen& other) const;
-    bool operator>(const Lumen& other) const;
-    bool operator<(const Lumen& other) const;
-    Lumen operator-(const Lumen& other) const;
-    Lumen& operator-=(const Lumen& other);
-    Lumen& operator--();
-    Lumen operator--(int);
+    BasicLumen& operator=(const BasicLumen& other);
+    BasicLumen operator+(const BasicLumen& other) const;
+    BasicLumen operator+(int value) const;
+
+    BasicLumen& operator+=(const BasicLumen& other);
+    BasicLumen& operator++();
+    BasicLumen operator++(int);
+    bool operator==(const BasicLumen& other) const;
+    bool operator!=(const BasicLumen& other) const;
+    bool operator>(const BasicLumen& other) const;
+    bool operator<(const BasicLumen& other) const;
+    BasicLumen operator-(const BasicLumen& other) const;
+    BasicLumen& operator-=(const BasicLumen& other);
+    BasicLumen& operator--();
+    BasicLumen operator--(int);
 
 
 private:
@@ -82,4 +170,10 @@ private:
     int calculateGlowValue();
 };
 
+// Instantiated once in lumen.cpp, so users of the header don't compile the member functions again
+extern template class BasicLumen<DefaultLumenPolicy>;
+extern template class BasicLumen<FixedPointLumenPolicy<> >;
+
+typedef BasicLumen<LUMEN_POLICY> Lumen;
+
 #endif // LUMEN_H
\ No newline at end of file
@@ -0,0 +1,222 @@
+/*
+ * lumenkernels.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements the bulk kernels of nova's element-wise operators over gathered blocks of lumen values.
+ * The vector versions are written once against a handful of wrappers, which map to AVX2 (8 lanes) or SSE2 (4 lanes)
+ * depending on what the compiler targets, and finish the last count % width entries with the scalar loop.
+ *
+ * ASSUMPTIONS:
+ *  1) Values stay far enough from INT_MIN and INT_MAX that sums and differences don't overflow, like the scalar
+ *     Lumen operators assume.
+ *
+*/
+
+#include "lumenkernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define KERNEL_WIDTH 8
+typedef __m256i KernelVector;
+static inline KernelVector vecLoad(const int* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+static inline void vecStore(int* values, KernelVector v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), v); }
+static inline KernelVector vecSet(int value) { return _mm256_set1_epi32(value); }
+static inline KernelVector vecAdd(KernelVector a, KernelVector b) { return _mm256_add_epi32(a, b); }
+static inline KernelVector vecSub(KernelVector a, KernelVector b) { return _mm256_sub_epi32(a, b); }
+static inline KernelVector vecAnd(KernelVector a, KernelVector b) { return _mm256_and_si256(a, b); }
+static inline KernelVector vecOr(KernelVector a, KernelVector b) { return _mm256_or_si256(a, b); }
+static inline KernelVector vecGreater(KernelVector a, KernelVector b) { return _mm256_cmpgt_epi32(a, b); }
+static inline int vecLaneMask(KernelVector v) { return _mm256_movemask_ps(_mm256_castsi256_ps(v)); }
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define KERNEL_WIDTH 4
+typedef __m128i KernelVector;
+static inline KernelVector vecLoad(const int* values) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)); }
+static inline void vecStore(int* values, KernelVector v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(values), v); }
+static inline KernelVector vecSet(int value) { return _mm_set1_epi32(value); }
+static inline KernelVector vecAdd(KernelVector a, KernelVector b) { return _mm_add_epi32(a, b); }
+static inline KernelVector vecSub(KernelVector a, KernelVector b) { return _mm_sub_epi32(a, b); }
+static inline KernelVector vecAnd(KernelVector a, KernelVector b) { return _mm_and_si128(a, b); }
+static inline KernelVector vecOr(KernelVector a, KernelVector b) { return _mm_or_si128(a, b); }
+static inline KernelVector vecGreater(KernelVector a, KernelVector b) { return _mm_cmpgt_epi32(a, b); }
+static inline int vecLaneMask(KernelVector v) { return _mm_movemask_ps(_mm_castsi128_ps(v)); }
+#else
+#define KERNEL_WIDTH 1
+#endif
+
+#if KERNEL_WIDTH > 1
+static const int FULL_LANE_MASK = (1 << KERNEL_WIDTH) - 1;
+#endif
+
+// Pre-Condition: values and other hold count entries
+// Post-Condition: values[k] += other[k] for every k
+void kernelAdd(int* values, const int* other, int count)
+{
+    int k = 0;
+#if KERNEL_WIDTH > 1
+    for (; k + KERNEL_WIDTH <= count; k += KERNEL_WIDTH)
+    {
+        vecStore(values + k, vecAdd(vecLoad(values + k), vecLoad(other + k)));
+    }
+#endif
+    for (; k < count; k++)
+    {
+        values[k] += other[k];
+    }
+}
+
+// Pre-Condition: values and other hold count entries
+// Post-Condition: values[k] -= other[k] for every k
+void kernelSubtract(int* values, const int* other, int count)
+{
+    int k = 0;
+#if KERNEL_WIDTH > 1
+    for (; k + KERNEL_WIDTH <= count; k += KERNEL_WIDTH)
+    {
+        vecStore(values + k, vecSub(vecLoad(values + k), vecLoad(other + k)));
+    }
+#endif
+    for (; k < count; k++)
+    {
+        values[k] -= other[k];
+    }
+}
+
+// Pre-Condition: values holds count entries
+// Post-Condition: values[k] += value for every k
+void kernelAddValue(int* values, int value, int count)
+{
+    if (value == 0)
+    {
+        return;
+    }
+    int k = 0;
+#if KERNEL_WIDTH > 1
+    KernelVector add = vecSet(value);
+    for (; k + KERNEL_WIDTH <= count; k += KERNEL_WIDTH)
+    {
+        vecStore(values + k, vecAdd(vecLoad(values + k), add));
+    }
+#endif
+    for (; k < count; k++)
+    {
+        values[k] += value;
+    }
+}
+
+// Pre-Condition: Both blocks hold the same count
+// Post-Condition: Every lumen of block has other's values added, like Lumen::operator+=
+void kernelAddBlock(LumenBlock& block, const LumenBlock& other)
+{
+    kernelAdd(block.brightness, other.brightness, block.count);
+    kernelAdd(block.size, other.size, block.count);
+    kernelAdd(block.power, other.power, block.count);
+}
+
+// Pre-Condition: Both blocks hold the same count
+// Post-Condition: Every lumen of block has other's values subtracted, like Lumen::operator-=
+void kernelSubtractBlock(LumenBlock& block, const LumenBlock& other)
+{
+    kernelSubtract(block.brightness, other.brightness, block.count);
+    kernelSubtract(block.size, other.size, block.count);
+    kernelSubtract(block.power, other.power, block.count);
+}
+
+// Pre-Condition: None
+// Post-Condition: Every lumen of block has the three values added to its brightness, size and power
+void kernelAddValueBlock(LumenBlock& block, int brightness, int size, int power)
+{
+    kernelAddValue(block.brightness, brightness, block.count);
+    kernelAddValue(block.size, size, block.count);
+    kernelAddValue(block.power, power, block.count);
+}
+
+// Pre-Condition: Both blocks hold the same count, changed holds count entries
+// Post-Condition: Lumens greater than their counterpart in all three values become the difference, like Lumen::operator-
+// where the clamp at 0 can't apply. changed[k] tells which lumens were, returns how many
+int kernelSubtractWhereGreater(LumenBlock& block, const LumenBlock& other, unsigned char* changed)
+{
+    int total = 0;
+    int k = 0;
+#if KERNEL_WIDTH > 1
+    for (; k + KERNEL_WIDTH <= block.count; k += KERNEL_WIDTH)
+    {
+        KernelVector b = vecLoad(block.brightness + k), ob = vecLoad(other.brightness + k);
+        KernelVector s = vecLoad(block.size + k), os = vecLoad(other.size + k);
+        KernelVector p = vecLoad(block.power + k), op = vecLoad(other.power + k);
+        KernelVector greater = vecAnd(vecAnd(vecGreater(b, ob), vecGreater(s, os)), vecGreater(p, op));
+        int lanes = vecLaneMask(greater);
+        if (lanes != 0)
+        {
+            // Lanes that aren't greater subtract 0
+            vecStore(block.brightness + k, vecSub(b, vecAnd(ob, greater)));
+            vecStore(block.size + k, vecSub(s, vecAnd(os, greater)));
+            vecStore(block.power + k, vecSub(p, vecAnd(op, greater)));
+        }
+        for (int lane = 0; lane < KERNEL_WIDTH; lane++)
+        {
+            changed[k + lane] = (unsigned char)((lanes >> lane) & 1);
+            total += (lanes >> lane) & 1;
+        }
+    }
+#endif
+    for (; k < block.count; k++)
+    {
+        bool greater = block.brightness[k] > other.brightness[k] && block.size[k] > other.size[k] &&
+                       block.power[k] > other.power[k];
+        changed[k] = greater ? 1 : 0;
+        if (!greater) continue;
+        block.brightness[k] -= other.brightness[k];
+        block.size[k] -= other.size[k];
+        block.power[k] -= other.power[k];
+        total++;
+    }
+    return total;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns whether every lumen could be built by the Lumen constructor: brightness and power not
+// negative, size positive. Stops at the first vector holding one that couldn't
+bool kernelAllValid(const LumenBlock& block)
+{
+    int k = 0;
+#if KERNEL_WIDTH > 1
+    KernelVector zero = vecSet(0);
+    KernelVector one = vecSet(1);
+    for (; k + KERNEL_WIDTH <= block.count; k += KERNEL_WIDTH)
+    {
+        KernelVector invalid = vecOr(vecOr(vecGreater(zero, vecLoad(block.brightness + k)),
+                                           vecGreater(one, vecLoad(block.size + k))),
+                                     vecGreater(zero, vecLoad(block.power + k)));
+        if (vecLaneMask(invalid) != 0) return false;
+    }
+#endif
+    for (; k < block.count; k++)
+    {
+        if (block.brightness[k] < 0 || block.size[k] <= 0 || block.power[k] < 0) return false;
+    }
+    return true;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the name of the instruction set the kernels were built for
+const char* kernelInstructionSet()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * Every kernel handles whole vectors first and the remaining entries with the scalar loop, so any count works and
+ * no load reads past count.
+ * Comparisons build a lane mask per vector, all ones in a lane means true. kernelAllValid() exits at the first
+ * vector holding an invalid lumen.
+ * Subtraction where greater never needs the clamp of Lumen::operator-, a difference of greater values is positive.
+ */
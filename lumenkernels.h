@@ -0,0 +1,38 @@
+/*
+ * lumenkernels.h
+ *
+ * This file declares the bulk kernels behind nova's element-wise operators. A nova gathers the brightness, size and
+ * power of a block of lumens into the contiguous arrays of a LumenBlock, runs a kernel over them, and writes the
+ * lumens that changed back. Kernels use AVX2 or SSE2 when the compiler targets them and plain loops otherwise, every
+ * version gives the same results.
+ *
+ */
+
+#ifndef LUMENKERNELS_H
+#define LUMENKERNELS_H
+
+/* Class Invariants:
+    * 1) Entry k of each array belongs to the lumen in slots[k], count entries are in use
+    * 2) Kernels only read and write the first count entries and never allocate
+*/
+
+struct LumenBlock {
+    static const int CAPACITY = 256;
+    int count;
+    int slots[CAPACITY];
+    int brightness[CAPACITY];
+    int size[CAPACITY];
+    int power[CAPACITY];
+};
+
+void kernelAdd(int* values, const int* other, int count);
+void kernelSubtract(int* values, const int* other, int count);
+void kernelAddValue(int* values, int value, int count);
+void kernelAddBlock(LumenBlock& block, const LumenBlock& other);
+void kernelSubtractBlock(LumenBlock& block, const LumenBlock& other);
+void kernelAddValueBlock(LumenBlock& block, int brightness, int size, int power);
+int kernelSubtractWhereGreater(LumenBlock& block, const LumenBlock& other, unsigned char* changed);
+bool kernelAllValid(const LumenBlock& block);
+const char* kernelInstructionSet();
+
+#endif
@@ -2,7 +2,26 @@
  * nova.cpp
  * Name: Robert Widjaja
  * Date: 4/14/2023
- * Revision History: 4/14/2023 -- finished documentation
+ * Revision History: 4/14/2023 -- finished documentation, 10/18/2026 -- added addLumen, removeLumen and reserve
+ * with amortized growth and reuse of vacant slots,
+ * 10/18/2026 -- added rvalue overloads of + and - that reuse the temporary's lumens,
+ * 10/18/2026 -- added dirty slot tracking for delta checkpoints,
+ * 10/18/2026 -- added opt-in workload recording,
+ * 10/18/2026 -- added incrementally maintained fingerprint and sums for O(1) inequality and hashing,
+ * 10/18/2026 -- added optional layout that groups lumens by glow state,
+ * 10/18/2026 -- added parallel construction, deep copy and destruction on an optional thread pool,
+ * 10/18/2026 -- added lazy novas whose pattern lumens are only allocated once they change,
+ * 10/18/2026 -- added a memory budget that spills cold lumen blocks to disk,
+ * 10/18/2026 -- added publishing of the lumens to a shared memory segment for reader processes,
+ * 10/18/2026 -- added a lock free command queue for glows, recharges and resets from other threads,
+ * 10/18/2026 -- moved the element-wise operators onto bulk SIMD kernels,
+ * 10/18/2026 -- added tick(), a single pass glow of every slot together with the min and max glow queries,
+ * 10/19/2026 -- the fingerprint counts changed lumens again only when it is read,
+ * 10/19/2026 -- removed the layout that grouped lumens by glow state, its glow was twice as slow as the plain loop,
+ * 10/19/2026 -- move assignment and queued recharges and resets are recorded,
+ * 10/19/2026 -- move assignment is noexcept again, memory budgets stay with their objects,
+ * 10/19/2026 -- novas that are only read keep to their memory budget,
+ * 10/19/2026 -- addLumen() refuses to append to a nova with virtual slots instead of allocating all of them
  * 
  * Platform: Windows
  * 
@@ -21,40 +40,89 @@
 */
 
 #include "nova.h"
+#include "sharednova.h"
+#include "commandqueue.h"
+#include "lumenkernels.h"
+#include "recorder.h"
+#include "threadpool.h"
 #include <iostream>
 #include <climits>
 #include <ctime>
 #include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
+#include <mutex>
 using namespace std;
 
 
 // Pre-Condtion: brightness, size and power should not be negative, lumen subobjects are injected into Nova
 // Post-Condition: first lumen is initialized along with the rest of the lumens for nova
 Nova::Nova(int brightness, int size, int power, int numLumens, Lumen** lumensInject)
+    : Nova(brightness, size, power, numLumens, lumensInject, nullptr)
+{
+}
+
+// Pre-Condtion: brightness, size and power should not be negative, lumen subobjects are injected into Nova,
+// pool may be nullptr
+// Post-Condition: Same nova as the constructor without a pool, the lumens are generated on the pool's threads
+Nova::Nova(int brightness, int size, int power, int numLumens, Lumen** lumensInject, ThreadPool* pool)
 {
     if (power < 0 || brightness < 0 || size <= 0 || numLumens < 0)
     {
         throw std::invalid_argument("Values must be non-negative!");
     }
     this->numLumens = numLumens;
+    this->liveLumens = numLumens;
+    this->capacity = numLumens;
+    this->threadPool = pool;
 
     lumens = lumensInject;
 
     // Create the first lumen object with specified brightness and size
     Lumen *firstLumen = new Lumen(brightness, size, power);
     lumens[0] = firstLumen;
-    // Generate remaining lumen objects with random values
-    for (int i = 1; i < numLumens; i++)
+    // Generate remaining lumen objects, each slot only depends on its index
+    runParallel(numLumens, [this](int begin, int end) {
+        for (int i = begin < 1 ? 1 : begin; i < end; i++)
+        {
+            lumens[i] = generateLumen(i);
+        }
+    });
+
+    // Nothing has been checkpointed yet, so every slot starts dirty
+    dirtyFlags.assign(numLumens, 1);
+    dirtySlots.resize(numLumens);
+    for (int i = 0; i < numLumens; i++)
     {
-        int b = (i * 123) % 600;
-        int s = (i * 123) % 20;
-        int p = (i * 123) % 400;
+        dirtySlots[i] = i;
+    }
+    accountAllLumens();
+}
 
-        Lumen *l = new Lumen(b, s, p);
-        lumens[i] = l;
+// Pre-Condtion: brightness, size and power should not be negative, numLumens is at least 1
+// Post-Condition: Same lumens as the constructor, but only the first one is allocated. The rest stay virtual and are
+// read from the pattern until they change
+Nova Nova::createLazy(int brightness, int size, int power, int numLumens)
+{
+    if (power < 0 || brightness < 0 || size <= 0 || numLumens < 1)
+    {
+        throw std::invalid_argument("Values must be non-negative and a nova needs at least one lumen!");
     }
+
+    Nova nova;
+    nova.lumens = new Lumen*[1];
+    nova.lumens[0] = new Lumen(brightness, size, power);
+    nova.numLumens = numLumens;
+    nova.liveLumens = numLumens;
+    nova.capacity = 1;
+    nova.virtualCount = numLumens - 1;
+
+    // Nothing has been checkpointed yet, the virtual slots are dirty as a block
+    nova.virtualDirty = true;
+    nova.dirtyFlags.assign(1, 1);
+    nova.dirtySlots.push_back(0);
+    nova.accountLumen(0);
+    return nova;
 }
 // Private utility for copying
 // Pre-condition: Assumes that 'other' is a valid 'Nova' object.
@@ -63,13 +131,27 @@ Nova::Nova(const Nova& other)
 {
     // Allocate memory for lumens array
     this->numLumens = other.numLumens;
-    lumens = new Lumen*[numLumens];
+    this->liveLumens = other.liveLumens;
+    this->capacity = other.numLumens - other.virtualCount;
+    this->freeSlots = other.freeSlots;
+    this->dirtyFlags = other.dirtyFlags;
+    this->dirtySlots = other.dirtySlots;
+    other.refreshFingerprint();
+    this->fingerprint = other.fingerprint;
+    this->brightnessSum = other.brightnessSum;
+    this->sizeSum = other.sizeSum;
+    this->powerSum = other.powerSum;
+    this->threadPool = other.threadPool;
+    this->virtualCount = other.virtualCount;
+    this->virtualDirty = other.virtualDirty;
+    this->virtualFingerprint = other.virtualFingerprint;
+    this->virtualFingerprintValid = other.virtualFingerprintValid;
+    this->fullFrameDue = true; // other's dirty slots say nothing about what a journal of the copy has seen
 
-    // Copy Lumen objects from 'other' to current object
-    for (int i = 0; i < numLumens; i++)
-    {
-        lumens[i] = new Lumen(*other.lumens[i]);
-    }
+    // Copy Lumen objects from 'other' to current object, vacant slots stay vacant
+    other.loadAll();
+    copyLumens(other);
+    other.enforceBudget(); // The copy has no budget, other spills again what it loaded for it
 }
 
 // Overloaded assignment operator
@@ -77,6 +159,7 @@ Nova::Nova(const Nova& other)
 // Post-condition: Copies the 'numLumens' and 'Lumen' objects from 'other' to the current object.
 Nova& Nova::operator=(const Nova& other)
 {
+    record(OP_COPY_ASSIGN, other.numLumens);
     if (this == &other)
     {
         // If self-assignment, return current object
@@ -84,19 +167,30 @@ Nova& Nova::operator=(const Nova& other)
     }
 
     // Deallocate existing memory
-    for (int i = 0; i < numLumens; i++)
-    {
-        delete lumens[i];
-    }
-    delete[] lumens;
+    releaseLumens();
 
     // Copy from other object
     this->numLumens = other.numLumens;
-    lumens = new Lumen*[numLumens];
-    for (int i = 0; i < numLumens; i++)
-    {
-        lumens[i] = new Lumen(*other.lumens[i]);
-    }
+    this->liveLumens = other.liveLumens;
+    this->capacity = other.numLumens - other.virtualCount;
+    this->freeSlots = other.freeSlots;
+    this->dirtyFlags = other.dirtyFlags;
+    this->dirtySlots = other.dirtySlots;
+    other.refreshFingerprint();
+    this->fingerprint = other.fingerprint;
+    this->brightnessSum = other.brightnessSum;
+    this->sizeSum = other.sizeSum;
+    this->powerSum = other.powerSum;
+    this->threadPool = other.threadPool;
+    this->virtualCount = other.virtualCount;
+    this->virtualDirty = other.virtualDirty;
+    this->virtualFingerprint = other.virtualFingerprint;
+    this->virtualFingerprintValid = other.virtualFingerprintValid;
+    this->fullFrameDue = true; // The journal of this nova only saw the old state, which may have had more slots
+    other.loadAll();
+    copyLumens(other);
+    enforceBudget();
+    other.enforceBudget();
 
     return *this;
 }
@@ -104,24 +198,101 @@ Nova& Nova::operator=(const Nova& other)
 // Move constructor supports efficient call by value
 // Pre-condition: Assumes that 'other' is a valid 'Nova' object.
 // Post-condition: Creates a new 'Nova' object by moving the 'numLumens' and 'Lumen' objects from 'other' to the current object.
-Nova::Nova(Nova&& other)
+Nova::Nova(Nova&& other) noexcept
 {
     this->numLumens = other.numLumens;
+    this->liveLumens = other.liveLumens;
+    this->capacity = other.capacity;
     this->lumens = other.lumens;
+    this->freeSlots = std::move(other.freeSlots);
+    this->dirtyFlags = std::move(other.dirtyFlags);
+    this->dirtySlots = std::move(other.dirtySlots);
+    this->fingerprint = other.fingerprint;
+    this->brightnessSum = other.brightnessSum;
+    this->sizeSum = other.sizeSum;
+    this->powerSum = other.powerSum;
+    this->staleFlags = std::move(other.staleFlags);
+    this->staleSlots = std::move(other.staleSlots);
+    this->fingerprintStale = other.fingerprintStale;
+    this->threadPool = other.threadPool;
+    this->virtualCount = other.virtualCount;
+    this->virtualDirty = other.virtualDirty;
+    this->virtualFingerprint = other.virtualFingerprint;
+    this->virtualFingerprintValid = other.virtualFingerprintValid;
+    this->fullFrameDue = other.fullFrameDue;
+    this->spillStore = other.spillStore;
     other.numLumens = 0;
+    other.liveLumens = 0;
+    other.capacity = 0;
     other.lumens = nullptr;
+    other.freeSlots.clear();
+    other.dirtyFlags.clear();
+    other.dirtySlots.clear();
+    other.fingerprint = 0;
+    other.brightnessSum = 0;
+    other.sizeSum = 0;
+    other.powerSum = 0;
+    other.staleFlags.clear();
+    other.staleSlots.clear();
+    other.fingerprintStale = false;
+    other.threadPool = nullptr;
+    other.virtualCount = 0;
+    other.virtualDirty = false;
+    other.virtualFingerprint = 0;
+    other.virtualFingerprintValid = false;
+    other.fullFrameDue = true; // other's journal has to see it emptied
+    other.spillStore = nullptr;
+    other.tickStamp = -1;
+    if (other.sharedSegment != nullptr)
+    {
+        other.sharedSegment->markAll(); // The segment stays with other, which now publishes an empty nova
+    }
 }
 
 // Move assignment exchanges ownership
-// Pre-condition: Assumes that 'other' is a valid 'Nova' object.
+// Pre-condition: Assumes that 'other' is a valid 'Nova' object, a spill file that can't be read ends the program
 // Post-condition: Moves the 'numLumens' and 'Lumen' objects from 'other' to the current object.
-Nova& Nova::operator=(Nova&& other)
+Nova& Nova::operator=(Nova&& other) noexcept
 {
+    record(OP_MOVE_ASSIGN, other.numLumens);
+    // Memory budgets stay with their objects like the segments, so both sides swap lumens that are all in memory
+    loadAll();
+    other.loadAll();
 
     // Move from other object
     swap(numLumens, other.numLumens);
-
+    swap(liveLumens, other.liveLumens);
+    swap(capacity, other.capacity);
     swap(lumens, other.lumens);
+    swap(freeSlots, other.freeSlots);
+    swap(dirtyFlags, other.dirtyFlags);
+    swap(dirtySlots, other.dirtySlots);
+    swap(fingerprint, other.fingerprint);
+    swap(brightnessSum, other.brightnessSum);
+    swap(sizeSum, other.sizeSum);
+    swap(powerSum, other.powerSum);
+    swap(staleFlags, other.staleFlags);
+    swap(staleSlots, other.staleSlots);
+    swap(fingerprintStale, other.fingerprintStale);
+    swap(threadPool, other.threadPool);
+    swap(virtualCount, other.virtualCount);
+    swap(virtualDirty, other.virtualDirty);
+    swap(virtualFingerprint, other.virtualFingerprint);
+    swap(virtualFingerprintValid, other.virtualFingerprintValid);
+    fullFrameDue = true; // Each journal saw the other state, so both write every slot next time
+    other.fullFrameDue = true;
+    tickStamp = -1; // The change counters stay, so neither prediction can be trusted
+    other.tickStamp = -1;
+
+    // Readers know a segment by its name, so it stays here and the swapped in state is published in full
+    if (sharedSegment != nullptr) sharedSegment->markAll();
+    if (other.sharedSegment != nullptr) other.sharedSegment->markAll();
+
+    // The block summaries described the old lumens, each side spills the new ones under its own budget
+    if (spillStore != nullptr) spillStore->clear();
+    if (other.spillStore != nullptr) other.spillStore->clear();
+    enforceBudget();
+    other.enforceBudget();
 
     if (this == &other)
     {
@@ -135,30 +306,1073 @@ Nova& Nova::operator=(Nova&& other)
 //Pre-Condition: None
 //Post-Condition: Deallocates/free the memory allocated for lumen array
 Nova::~Nova() 
+{
+    releaseLumens();
+    delete spillStore;
+    delete sharedSegment;
+    delete commandQueue;
+}
+
+// Helper method shared by the destructor and copy assignment
+// Pre-Condition: None
+// Post-Condition: Deletes every lumen and the array of pointers, leaving nova without storage
+void Nova::releaseLumens()
 {
     // Deallocate memory for lumens array and each Lumen object
-    for (int i = 0; i < this->numLumens; i++) {
-        delete this->lumens[i]; // Delete each Lumen object
-    }
+    runParallel(this->numLumens - this->virtualCount, [this](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            delete this->lumens[i]; // Delete each Lumen object, vacant slots hold nullptr
+        }
+    });
     delete[] this->lumens; // Delete the array of pointers
+    this->lumens = nullptr;
+    this->numLumens = 0;
+    this->liveLumens = 0;
+    this->capacity = 0;
+    this->virtualCount = 0;
+    this->virtualDirty = false;
+    this->virtualFingerprint = 0;
+    this->virtualFingerprintValid = false;
+    this->tickStamp = -1;
+    if (this->spillStore != nullptr)
+    {
+        this->spillStore->clear(); // Spilled lumens are dropped with the rest, the file is simply overwritten later
+    }
+    if (this->sharedSegment != nullptr)
+    {
+        this->sharedSegment->markAll(); // Whatever replaces the lumens is published in full
+    }
+    this->freeSlots.clear();
+    this->dirtyFlags.clear();
+    this->dirtySlots.clear();
+    this->fingerprint = 0;
+    this->brightnessSum = 0;
+    this->sizeSum = 0;
+    this->powerSum = 0;
+    this->staleFlags.clear();
+    this->staleSlots.clear();
+    this->fingerprintStale = false;
+}
+
+// Pre-Condition: brightness, size and power should not be negative
+// Post-Condition: Creates a lumen and places it in a vacant slot or at the end, returns the slot index
+int Nova::addLumen(int brightness, int size, int power)
+{
+    return addLumen(new Lumen(brightness, size, power));
+}
+
+// Pre-Condition: lumen is a heap allocated Lumen object, nova takes ownership of it. Throw exception when there is no
+// vacant slot and the nova still has virtual slots, appending would have to allocate every one of them first
+// Post-Condition: Reuses the most recently vacated slot if there is one, otherwise appends and grows the array geometrically.
+// Returns the slot index which stays valid until the lumen is removed
+int Nova::addLumen(Lumen* lumen)
+{
+    if (lumen == nullptr)
+    {
+        throw std::invalid_argument("Lumen to add must not be null");
+    }
+    LumenState state = lumen->getState();
+    record(OP_ADD_LUMEN, state.brightness, state.size, state.power);
+
+    int slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        ensureResident(slot, slot + 1);
+    }
+    else
+    {
+        // New slots go after the virtual ones, a lazy nova of a billion slots would allocate them all for one append
+        if (virtualCount > 0)
+        {
+            delete lumen;
+            throw std::invalid_argument("Can't append a lumen while the nova has virtual slots");
+        }
+        ensureResident(numLumens - 1, numLumens); // The last block has to be in memory before it gets a new slot
+        if (numLumens == capacity)
+        {
+            grow(capacity > 0 ? capacity * 2 : 1);
+        }
+        slot = numLumens++;
+        dirtyFlags.push_back(0);
+    }
+
+    lumens[slot] = lumen;
+    liveLumens++;
+    markStale(slot); // Counted the next time the fingerprint is read
+    markDirty(slot);
+    enforceBudget();
+    return slot;
+}
+
+// Pre-Condition: Throw exception when slot is out of bounds or already vacant
+// Post-Condition: Deletes the lumen in the slot and remembers the slot for reuse, other slot indices are unchanged
+void Nova::removeLumen(int slot)
+{
+    record(OP_REMOVE_LUMEN, slot);
+    if (slot >= 0 && slot < numLumens)
+    {
+        ensureResident(slot, slot + 1);
+    }
+    if (slot < 0 || slot >= numLumens || isVacant(slot))
+    {
+        throw std::invalid_argument("Slot to remove is out of bounds or vacant");
+    }
+    materialize(slot + 1);
+
+    beginLumenUpdate(slot); // A vacant stale slot is skipped when the fingerprint is counted again
+    delete lumens[slot];
+    lumens[slot] = nullptr;
+    liveLumens--;
+    freeSlots.push_back(slot);
+    markDirty(slot);
+}
+
+// Pre-Condition: Throw exception when newCapacity is negative
+// Post-Condition: The array can hold at least newCapacity slots without reallocating, never shrinks
+void Nova::reserve(int newCapacity)
+{
+    record(OP_RESERVE, newCapacity);
+    if (newCapacity < 0)
+    {
+        throw std::invalid_argument("Capacity must be non-negative!");
+    }
+    if (newCapacity > capacity)
+    {
+        grow(newCapacity);
+    }
+}
+
+// Helper method shared by reserve and addLumen
+// Pre-Condition: newCapacity is greater than the current capacity
+// Post-Condition: Moves the lumen pointers into a larger array
+void Nova::grow(int newCapacity)
+{
+    Lumen** grown = new Lumen*[newCapacity];
+    for (int i = 0; i < numLumens - virtualCount; i++)
+    {
+        grown[i] = lumens[i];
+    }
+    delete[] lumens;
+    lumens = grown;
+    capacity = newCapacity;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of lumens, not counting vacant slots
+int Nova::getLumenCount() const
+{
+    return liveLumens;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of slots in use, including vacant ones
+int Nova::getSlotCount() const
+{
+    return numLumens;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of slots allocated
+int Nova::getCapacity() const
+{
+    return capacity;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of slots that are allocated or vacant, the rest are virtual
+int Nova::getMaterializedCount() const
+{
+    return numLumens - virtualCount;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of slots changed since the last checkpoint
+int Nova::getDirtyCount() const
+{
+    if (fullFrameDue)
+    {
+        return numLumens;
+    }
+    return (int)dirtySlots.size() + (virtualDirty ? virtualCount : 0);
+}
+
+// Pre-Condition: slot is within bounds
+// Post-Condition: The slot is recorded once in the dirty list until the next checkpoint
+void Nova::markDirty(int slot)
+{
+    changeCount++;
+    if (!dirtyFlags[slot])
+    {
+        dirtyFlags[slot] = 1;
+        dirtySlots.push_back(slot);
+    }
+    if (sharedSegment != nullptr)
+    {
+        sharedSegment->markChanged(slot);
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: No slot is dirty, called once a checkpoint has been written
+void Nova::clearDirty()
+{
+    for (size_t i = 0; i < dirtySlots.size(); i++)
+    {
+        dirtyFlags[dirtySlots[i]] = 0;
+    }
+    dirtySlots.clear();
+    virtualDirty = false;
+    fullFrameDue = false;
+}
+
+// Pre-Condition: recorder outlives its attachment, nullptr stops recording
+// Post-Condition: Every later public call on this nova is logged to the recorder, copies of the nova are not recorded
+void Nova::setRecorder(WorkloadRecorder* recorder)
+{
+    this->recorder = recorder;
+}
+
+// Pre-Condition: pool outlives the nova and its copies, or is nullptr
+// Post-Condition: Later constructions, copies and releases of the lumens run on the pool's threads
+void Nova::setThreadPool(ThreadPool* pool)
+{
+    this->threadPool = pool;
+}
+
+// Helper method for loops over slots
+// Pre-Condition: body only touches the slots in its range, or guards what it shares
+// Post-Condition: body has covered [0, count), split across the thread pool if there is one
+void Nova::runParallel(int count, const std::function<void(int, int)>& body) const
+{
+    if (threadPool != nullptr)
+    {
+        threadPool->parallelFor(count, PARALLEL_GRAIN, body);
+    }
+    else if (count > 0)
+    {
+        body(0, count);
+    }
+}
+
+// Helper method shared by the copy constructor and copy assignment
+// Pre-Condition: numLumens, capacity and virtualCount are already copied from other, lumens holds no array
+// Post-Condition: lumens holds a deep copy of every allocated slot of other, virtual slots stay virtual
+void Nova::copyLumens(const Nova& other)
+{
+    lumens = new Lumen*[capacity];
+    runParallel(numLumens - virtualCount, [this, &other](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            lumens[i] = other.isVacant(i) ? nullptr : new Lumen(*other.lumens[i]);
+        }
+    });
+}
+
+// Helper method for counting a whole new array of lumens
+// Pre-Condition: No live slot is counted in the fingerprint and sums yet
+// Post-Condition: Every live slot is counted, each thread sums its chunks before adding them in
+void Nova::accountAllLumens() const
+{
+    std::mutex mergeLock;
+    runParallel(numLumens - virtualCount, [this, &mergeLock](int begin, int end) {
+        unsigned long long chunkFingerprint = 0;
+        long long chunkBrightness = 0;
+        long long chunkSize = 0;
+        long long chunkPower = 0;
+        for (int i = begin; i < end; i++)
+        {
+            if (isVacant(i)) continue;
+            chunkFingerprint += lumenHash(i);
+            chunkBrightness += lumens[i]->getBrightness();
+            chunkSize += lumens[i]->getSize();
+            chunkPower += lumens[i]->getPower();
+        }
+
+        std::lock_guard<std::mutex> guard(mergeLock);
+        fingerprint += chunkFingerprint;
+        brightnessSum += chunkBrightness;
+        sizeSum += chunkSize;
+        powerSum += chunkPower;
+    });
+}
+
+// Helper method for the constructor's lumen pattern
+// Pre-Condition: slot is at least 1
+// Post-Condition: Returns a new lumen whose values only depend on slot
+Lumen* Nova::generateLumen(int slot)
+{
+    return new Lumen(patternLumen(slot));
+}
+
+// Helper method for reading the pattern without allocating
+// Pre-Condition: slot is at least 1, the returned lumen must not be changed
+// Post-Condition: Returns the lumen the constructor generates for slot, shared by every slot with the same remainder
+Lumen& Nova::patternLumen(int slot)
+{
+    // (i * 123) % 600, % 20 and % 400 only depend on (i * 123) % 1200, which repeats every 400 slots
+    static std::vector<Lumen> table = [] {
+        std::vector<Lumen> built;
+        built.reserve(PATTERN_PERIOD);
+        for (int i = 0; i < PATTERN_PERIOD; i++)
+        {
+            int pattern = (i == 0 ? PATTERN_PERIOD : i) * 123;
+            int size = pattern % 20;
+            built.push_back(Lumen(pattern % 600, size == 0 ? 1 : size, pattern % 400)); // A lumen can't have size 0
+        }
+        return built;
+    }();
+    return table[slot % PATTERN_PERIOD];
+}
+
+// Helper method for querying virtual slots
+// Pre-Condition: 1 <= begin <= end
+// Post-Condition: Widens minGlow and maxGlow to cover glowQuery() of the pattern lumens in [begin, end), visiting at
+// most one period of slots
+void Nova::patternGlowRange(int begin, int end, int& minGlow, int& maxGlow)
+{
+    if (end - begin > PATTERN_PERIOD)
+    {
+        end = begin + PATTERN_PERIOD;
+    }
+    for (int i = begin; i < end; i++)
+    {
+        int glow = patternLumen(i).glowQuery();
+        if (glow < minGlow) minGlow = glow;
+        if (glow > maxGlow) maxGlow = glow;
+    }
+}
+
+// Helper method for allocating virtual slots
+// Pre-Condition: end is at most numLumens
+// Post-Condition: Every slot before end holds an allocated lumen or is vacant, the nova's state is unchanged
+void Nova::materialize(int end)
+{
+    int begin = numLumens - virtualCount;
+    if (end <= begin)
+    {
+        return;
+    }
+    ensureResident(begin - 1, begin); // A spilled last block must be in memory before it gets more slots
+
+    if (end > capacity)
+    {
+        long long grown = std::max((long long)capacity * 2, (long long)end);
+        grow((int)std::min(grown, (long long)numLumens));
+    }
+    runParallel(end - begin, [this, begin](int first, int last) {
+        for (int i = begin + first; i < begin + last; i++)
+        {
+            lumens[i] = generateLumen(i);
+        }
+    });
+    virtualCount = numLumens - end;
+
+    // The lumens were already part of the nova, they just move from the virtual share to the allocated one
+    dirtyFlags.resize(end, virtualDirty ? 1 : 0);
+    for (int i = begin; i < end; i++)
+    {
+        if (virtualDirty) dirtySlots.push_back(i);
+        if (virtualFingerprintValid) virtualFingerprint -= lumenHash(i);
+        markStale(i);
+    }
+}
+
+// Pre-Condition: bytes is not negative, spillPath is a writable scratch file used when bytes is not 0
+// Post-Condition: With a budget, cold blocks are spilled until the footprint fits, and again after each glow() or
+// addLumen(). 0 removes the budget and loads every spilled block back
+void Nova::setMemoryBudget(long long bytes, const std::string& spillPath)
+{
+    if (bytes < 0)
+    {
+        throw std::invalid_argument("Memory budget must be non-negative!");
+    }
+    if (bytes > 0 && sharedSegment != nullptr)
+    {
+        throw std::invalid_argument("Shared memory can't be used with a memory budget");
+    }
+    if (spillStore != nullptr)
+    {
+        loadAll();
+        delete spillStore;
+        spillStore = nullptr;
+    }
+    if (bytes == 0)
+    {
+        return;
+    }
+
+    spillStore = new SpillStore(spillPath, bytes);
+    enforceBudget();
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the bytes held in memory by the nova, its slot array, its lumens in memory and its bookkeeping
+long long Nova::getMemoryFootprint() const
+{
+    long long residentLumens = liveLumens - virtualCount - (spillStore != nullptr ? spillStore->getSpilledLumens() : 0);
+    long long ints = (long long)(dirtySlots.capacity() + freeSlots.capacity() + staleSlots.capacity());
+    long long bytes = (long long)sizeof(Nova) + (long long)capacity * (long long)sizeof(Lumen*) +
+                      residentLumens * (long long)sizeof(Lumen) + ints * (long long)sizeof(int) +
+                      (long long)(dirtyFlags.capacity() + staleFlags.capacity());
+    if (spillStore != nullptr)
+    {
+        bytes += (long long)sizeof(SpillStore) + (long long)spillStore->getBlockCount() * (long long)sizeof(SpillBlock);
+    }
+    return bytes;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the spill counters, all 0 without a memory budget
+SpillStats Nova::getSpillStats() const
+{
+    return spillStore != nullptr ? spillStore->getStats() : SpillStats();
+}
+
+// Pre-Condition: name starts with '/', an empty name turns shared memory off
+// Post-Condition: Creates the POSIX shared memory segment name and publishes every slot to it, readers can attach
+// with SharedNovaReader. Any segment this nova had before is removed
+void Nova::setSharedMemory(const std::string& name)
+{
+    if (!name.empty() && spillStore != nullptr)
+    {
+        throw std::invalid_argument("Shared memory can't be used with a memory budget");
+    }
+    delete sharedSegment;
+    sharedSegment = nullptr;
+    if (name.empty())
+    {
+        return;
+    }
+
+    sharedSegment = new SharedNovaSegment(name);
+    publishShared();
+}
+
+// Pre-Condition: None
+// Post-Condition: Readers see the current state, only slots changed since the last publish are written.
+// Does nothing while shared memory is off
+void Nova::publishShared()
+{
+    if (sharedSegment == nullptr)
+    {
+        return;
+    }
+
+    sharedSegment->beginWrite(numLumens, liveLumens);
+    if (sharedSegment->needsFullPublish())
+    {
+        // A lazy nova's virtual slots are written too, readers have no pattern to fall back on
+        for (int slot = 0; slot < numLumens; slot++)
+        {
+            sharedSegment->writeSlot(slot, isVacant(slot) ? nullptr : &lumenAt(slot));
+        }
+    }
+    else
+    {
+        const std::vector<int>& changed = sharedSegment->getChangedSlots();
+        for (size_t i = 0; i < changed.size(); i++)
+        {
+            int slot = changed[i];
+            sharedSegment->writeSlot(slot, isVacant(slot) ? nullptr : &lumenAt(slot));
+        }
+    }
+    sharedSegment->endWrite();
+}
+
+// Pre-Condition: capacity is not negative, no producer is using the current queue
+// Post-Condition: Commands still in the current queue are applied, then it is replaced by an empty queue of at least
+// capacity commands. 0 removes the queue
+void Nova::setCommandQueue(int capacity)
+{
+    if (capacity < 0)
+    {
+        throw std::invalid_argument("Queue capacity must be non-negative!");
+    }
+    if (commandQueue != nullptr)
+    {
+        drainCommands(INT_MAX);
+        delete commandQueue;
+        commandQueue = nullptr;
+    }
+    if (capacity > 0)
+    {
+        commandQueue = new NovaCommandQueue(capacity);
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the queue producers push to, nullptr if there is none. Only the queue is safe to use from
+// other threads, the nova itself isn't
+NovaCommandQueue* Nova::getCommandQueue() const
+{
+    return commandQueue;
+}
+
+// Pre-Condition: maxCommands is not negative, called on the thread that owns the nova
+// Post-Condition: Applies up to maxCommands queued commands in the order they were queued and returns how many ran.
+// Commands are popped and completed in batches, a command that throws is skipped and counted as failed
+int Nova::drainCommands(int maxCommands)
+{
+    if (maxCommands < 0)
+    {
+        throw std::invalid_argument("Number of commands must be non-negative!");
+    }
+    if (commandQueue == nullptr)
+    {
+        return 0;
+    }
+
+    NovaCommand batch[COMMAND_BATCH];
+    int drained = 0;
+    while (drained < maxCommands)
+    {
+        int count = commandQueue->pop(batch, maxCommands - drained < COMMAND_BATCH ? maxCommands - drained : COMMAND_BATCH);
+        if (count == 0)
+        {
+            break;
+        }
+
+        int failed = 0;
+        for (int i = 0; i < count; i++)
+        {
+            try
+            {
+                if (batch[i].op == CMD_GLOW) glow(batch[i].arg);
+                else if (batch[i].op == CMD_RECHARGE) { record(OP_RECHARGE); internalRecharge(); }
+                else if (batch[i].op == CMD_RESET) { record(OP_RESET); replaceUnstableLumens(); }
+                else throw std::invalid_argument("Unknown command");
+            }
+            catch (const std::exception&)
+            {
+                failed++;
+            }
+        }
+        commandQueue->complete(count, failed);
+        drained += count;
+    }
+
+    // Recharge and reset can page spilled blocks in without spilling any
+    if (drained > 0)
+    {
+        enforceBudget();
+    }
+    return drained;
+}
+
+// Helper method for paging in a range of slots
+// Pre-Condition: 0 <= begin, end <= numLumens
+// Post-Condition: Every spilled block overlapping [begin, end) is back in memory, the blocks count as used.
+// Loading doesn't change the nova's state, so it is allowed on a const nova
+void Nova::ensureResident(int begin, int end) const
+{
+    if (spillStore == nullptr || begin < 0 || begin >= end)
+    {
+        return;
+    }
+
+    int first = begin / SpillStore::BLOCK_SLOTS;
+    int last = std::min((end - 1) / SpillStore::BLOCK_SLOTS, spillStore->getBlockCount() - 1);
+    long long use = spillStore->nextUse();
+    std::vector<int> missing;
+    for (int b = first; b <= last; b++)
+    {
+        SpillBlock& block = spillStore->getBlock(b);
+        block.lastUse = use;
+        if (block.spilled)
+        {
+            spillStore->getStats().misses++;
+            missing.push_back(b);
+        }
+        else
+        {
+            spillStore->getStats().hits++;
+        }
+    }
+    loadBlocks(missing);
+}
+
+// Helper method for operations that read every lumen
+// Pre-Condition: None
+// Post-Condition: No block is spilled
+void Nova::loadAll() const
+{
+    ensureResident(0, numLumens - virtualCount);
+}
+
+// Helper method for reading spilled blocks back
+// Pre-Condition: blocks lists spilled blocks in ascending order
+// Post-Condition: Their lumens are allocated again from the spill file
+void Nova::loadBlocks(const std::vector<int>& blocks) const
+{
+    std::vector<SpillRecord> records;
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        int begin = blocks[i] * SpillStore::BLOCK_SLOTS;
+        records.resize(std::min(begin + SpillStore::BLOCK_SLOTS, numLumens - virtualCount) - begin);
+        spillStore->readBlock(blocks[i], records);
+        for (size_t k = 0; k < records.size(); k++)
+        {
+            lumens[begin + k] = records[k].live ? new Lumen(records[k].state) : nullptr;
+        }
+
+        SpillBlock& block = spillStore->getBlock(blocks[i]);
+        block.spilled = false;
+        spillStore->addSpilledLumens(-block.live);
+    }
+}
+
+// Helper method for replace and internal recharge
+// Pre-Condition: None
+// Post-Condition: Loads the spilled blocks holding a lumen that recharge, or replace, would change
+void Nova::loadBlocksToChange(bool forRecharge) const
+{
+    if (spillStore == nullptr)
+    {
+        return;
+    }
+    std::vector<int> changing;
+    for (int b = 0; b < spillStore->getBlockCount(); b++)
+    {
+        const SpillBlock& block = spillStore->getBlock(b);
+        if (block.spilled && (forRecharge ? block.rechargeable : block.replaceable) > 0)
+        {
+            changing.push_back(b);
+        }
+    }
+    loadBlocks(changing);
+}
+
+// Helper method for querying spilled blocks
+// Pre-Condition: None
+// Post-Condition: Widens minGlow and maxGlow with the glow range saved for each spilled block
+void Nova::spilledGlowRange(int& minGlow, int& maxGlow) const
+{
+    for (int b = 0; spillStore != nullptr && b < spillStore->getBlockCount(); b++)
+    {
+        const SpillBlock& block = spillStore->getBlock(b);
+        if (!block.spilled || block.live == 0) continue;
+        if (block.minGlow < minGlow) minGlow = block.minGlow;
+        if (block.maxGlow > maxGlow) maxGlow = block.maxGlow;
+    }
+}
+
+// Helper method for keeping to the memory budget
+// Pre-Condition: None
+// Post-Condition: If the footprint is over budget, the least recently used blocks are spilled in one batch until it
+// is an eighth below budget, or no block with lumens is left in memory. Like loading, spilling doesn't change the
+// nova's state, so a const nova gives back what it paged in to be read
+void Nova::enforceBudget() const
+{
+    if (spillStore == nullptr)
+    {
+        return;
+    }
+    int materialized = numLumens - virtualCount;
+    int blockCount = (materialized + SpillStore::BLOCK_SLOTS - 1) / SpillStore::BLOCK_SLOTS;
+    if (blockCount > spillStore->getBlockCount())
+    {
+        spillStore->setBlockCount(blockCount);
+    }
+
+    long long footprint = getMemoryFootprint();
+    long long budget = spillStore->getBudget();
+    if (footprint <= budget)
+    {
+        return;
+    }
+
+    // Spilling below the budget leaves room for the next few ticks, so evictions come in batches
+    long long excess = footprint - (budget - budget / 8);
+    std::vector<int> candidates;
+    for (int b = 0; b < blockCount; b++)
+    {
+        if (!spillStore->getBlock(b).spilled) candidates.push_back(b);
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](int first, int second) {
+        long long firstUse = spillStore->getBlock(first).lastUse;
+        long long secondUse = spillStore->getBlock(second).lastUse;
+        return firstUse != secondUse ? firstUse < secondUse : first > second; // Later blocks are colder on a tie
+    });
+
+    std::vector<int> victims;
+    for (size_t i = 0; i < candidates.size() && excess > 0; i++)
+    {
+        int begin = candidates[i] * SpillStore::BLOCK_SLOTS;
+        int end = std::min(begin + SpillStore::BLOCK_SLOTS, materialized);
+        int live = 0;
+        for (int slot = begin; slot < end; slot++)
+        {
+            if (!isVacant(slot)) live++;
+        }
+        if (live == 0) continue; // Nothing to free
+        victims.push_back(candidates[i]);
+        excess -= (long long)live * (long long)sizeof(Lumen);
+    }
+    std::sort(victims.begin(), victims.end());
+    refreshFingerprint(); // Spilled slots hold nullptr, so their lumens have to be counted while still in memory
+
+    std::vector<SpillRecord> records;
+    for (size_t i = 0; i < victims.size(); i++)
+    {
+        int begin = victims[i] * SpillStore::BLOCK_SLOTS;
+        int end = std::min(begin + SpillStore::BLOCK_SLOTS, materialized);
+        SpillBlock& block = spillStore->getBlock(victims[i]);
+        block.live = 0;
+        block.inactive = 0;
+        block.rechargeable = 0;
+        block.replaceable = 0;
+        block.minGlow = INT_MAX;
+        block.maxGlow = INT_MIN;
+
+        records.assign(end - begin, SpillRecord());
+        for (int slot = begin; slot < end; slot++)
+        {
+            if (isVacant(slot)) continue;
+            LumenState state = lumens[slot]->getState();
+            records[slot - begin].live = 1;
+            records[slot - begin].state = state;
+
+            // Summary of what glow() and the queries would do with the lumen, it can't change while spilled
+            bool stable = state.power > state.stableThreshold && state.power > state.powerThreshold;
+            int glow = lumens[slot]->glowQuery();
+            block.live++;
+            block.inactive += state.isActive ? 0 : 1;
+            block.rechargeable += stable && (state.power != state.originalPower ||
+                                             (!state.isActive && state.originalPower > state.powerThreshold));
+            block.replaceable += state.unstableCount > UNSTABLE_THRESHOLD && !lumens[slot]->resetIsNoOp();
+            if (glow < block.minGlow) block.minGlow = glow;
+            if (glow > block.maxGlow) block.maxGlow = glow;
+        }
+
+        spillStore->writeBlock(victims[i], records);
+        for (int slot = begin; slot < end; slot++)
+        {
+            delete lumens[slot];
+            lumens[slot] = nullptr;
+        }
+        block.spilled = true;
+        spillStore->addSpilledLumens(block.live);
+    }
+    spillStore->flush();
+}
+
+// Helper method for reading a slot that may be virtual
+// Pre-Condition: slot is within bounds and not vacant
+// Post-Condition: Returns the slot's lumen, or the pattern lumen it stands for
+const Lumen& Nova::lumenAt(int slot) const
+{
+    return slot < numLumens - virtualCount ? *lumens[slot] : patternLumen(slot);
+}
+
+// Helper method for logging a call
+// Pre-Condition: op is a WorkloadOp
+// Post-Condition: The call is logged if a recorder is attached
+void Nova::record(int op, int arg0, int arg1, int arg2) const
+{
+    if (recorder != nullptr)
+    {
+        recorder->record(op, arg0, arg1, arg2);
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the order-sensitive fingerprint of every lumen's brightness, size and power
+unsigned long long Nova::getFingerprint() const
+{
+    refreshFingerprint();
+    // Virtual slots are hashed once on first use, materialize() keeps the share current after that
+    if (!virtualFingerprintValid)
+    {
+        virtualFingerprint = 0;
+        for (int i = numLumens - virtualCount; i < numLumens; i++)
+        {
+            virtualFingerprint += slotHash(i, patternLumen(i));
+        }
+        virtualFingerprintValid = true;
+    }
+    return fingerprint + virtualFingerprint;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns a hash that is equal for equal novas and the same from run to run
+size_t Nova::hash() const
+{
+    return (size_t)mixHash(getFingerprint() ^ ((unsigned long long)numLumens << 32));
+}
+
+// Helper method for hashing, the splitmix64 finalizer
+// Pre-Condition: None
+// Post-Condition: Returns a well mixed 64 bit value
+unsigned long long Nova::mixHash(unsigned long long value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Helper method for hashing one slot
+// Pre-Condition: slot holds a lumen
+// Post-Condition: Returns the slot's share of the fingerprint
+unsigned long long Nova::lumenHash(int slot) const
+{
+    return slotHash(slot, *lumens[slot]);
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns a hash of the slot index and the lumen's brightness, size and power
+unsigned long long Nova::slotHash(int slot, const Lumen& lumen)
+{
+    return slotHash(slot, lumen.getBrightness(), lumen.getSize(), lumen.getPower());
+}
+
+// Helper method for hashing values that aren't in a lumen yet
+// Pre-Condition: None
+// Post-Condition: Returns the hash a lumen with these values would have in slot
+unsigned long long Nova::slotHash(int slot, int brightness, int size, int power)
+{
+    unsigned long long value = mixHash((unsigned long long)slot * 0x9e3779b97f4a7c15ULL + (unsigned int)brightness);
+    value = mixHash(value + (unsigned int)size);
+    return mixHash(value + (unsigned int)power);
+}
+
+// Pre-Condition: slot holds a lumen that is not counted in the fingerprint and sums
+// Post-Condition: The lumen is counted in the fingerprint and sums
+void Nova::accountLumen(int slot) const
+{
+    fingerprint += lumenHash(slot);
+    brightnessSum += lumens[slot]->getBrightness();
+    sizeSum += lumens[slot]->getSize();
+    powerSum += lumens[slot]->getPower();
+}
+
+// Pre-Condition: slot holds a lumen that is counted in the fingerprint and sums
+// Post-Condition: The lumen is no longer counted in the fingerprint and sums
+void Nova::unaccountLumen(int slot)
+{
+    fingerprint -= lumenHash(slot);
+    brightnessSum -= lumens[slot]->getBrightness();
+    sizeSum -= lumens[slot]->getSize();
+    powerSum -= lumens[slot]->getPower();
+}
+
+// Pre-Condition: slot is allocated and left out of the fingerprint and sums
+// Post-Condition: The slot is stale, the next reader of the fingerprint counts it again. Once an eighth of the slots
+// are stale the whole fingerprint is, unless blocks can be spilled, whose lumens a full recount couldn't see
+void Nova::markStale(int slot)
+{
+    if (fingerprintStale)
+    {
+        return;
+    }
+    if (spillStore == nullptr && staleSlots.size() >= (size_t)(numLumens / 8) + 64)
+    {
+        for (size_t i = 0; i < staleSlots.size(); i++)
+        {
+            staleFlags[staleSlots[i]] = 0;
+        }
+        staleSlots.clear();
+        fingerprintStale = true;
+        return;
+    }
+    if (slot >= (int)staleFlags.size())
+    {
+        staleFlags.resize(std::max(slot + 1, numLumens), 0);
+    }
+    if (!staleFlags[slot])
+    {
+        staleFlags[slot] = 1;
+        staleSlots.push_back(slot);
+    }
+}
+
+// Pre-Condition: Every stale slot is in memory, no block is spilled while the whole fingerprint is stale
+// Post-Condition: The lumens of the stale slots are counted in the fingerprint and sums, no slot is stale
+void Nova::refreshFingerprint() const
+{
+    if (fingerprintStale)
+    {
+        fingerprint = 0;
+        brightnessSum = 0;
+        sizeSum = 0;
+        powerSum = 0;
+        accountAllLumens();
+        fingerprintStale = false;
+        return;
+    }
+    for (size_t i = 0; i < staleSlots.size(); i++)
+    {
+        int slot = staleSlots[i];
+        staleFlags[slot] = 0;
+        if (!isVacant(slot))
+        {
+            accountLumen(slot);
+        }
+    }
+    staleSlots.clear();
+}
+
+// Pre-Condition: slot holds a lumen, called right before the lumen changes
+// Post-Condition: The lumen's old values are taken out of the fingerprint and sums unless the slot already was stale,
+// the new ones are only hashed when the fingerprint is read
+void Nova::beginLumenUpdate(int slot)
+{
+    if (fingerprintStale || (slot < (int)staleFlags.size() && staleFlags[slot]))
+    {
+        return;
+    }
+    unaccountLumen(slot);
+    markStale(slot);
+}
+
+// Pre-Condition: slot holds a lumen, called right after the lumen changed
+// Post-Condition: The slot is dirty
+void Nova::endLumenUpdate(int slot)
+{
+    markDirty(slot);
+}
+
+// Pre-Condition: slot is within bounds
+// Post-Condition: Returns true if the slot holds no lumen
+bool Nova::isVacant(int slot) const
+{
+    return slot < numLumens - virtualCount && lumens[slot] == nullptr;
+}
+
+// Pre-Condition: Both novas have the same number of slots
+// Post-Condition: Returns false if the fingerprints or sums show the novas can't be equal, in O(1). Returns true when
+// either summary still has slots to count, counting them costs more than the scan it would save
+bool Nova::sameSummary(const Nova& other) const
+{
+    if (fingerprintStale || !staleSlots.empty() || other.fingerprintStale || !other.staleSlots.empty())
+    {
+        return true;
+    }
+    return liveLumens == other.liveLumens && fingerprint == other.fingerprint && brightnessSum == other.brightnessSum &&
+           sizeSum == other.sizeSum && powerSum == other.powerSum;
+}
+
+// Pre-Condition: slot is within bounds of the current object
+// Post-Condition: Returns true if both novas hold a lumen in the slot, used by the element-wise operators
+bool Nova::bothLive(const Nova& other, int slot) const
+{
+    return slot < other.numLumens && !isVacant(slot) && !other.isVacant(slot);
+}
+
+// Helper method for the bulk operators
+// Pre-Condition: [begin, end) holds at most LumenBlock::CAPACITY slots, otherBlock is given when other is
+// Post-Condition: block holds the values of the lumens in [begin, end) that are live here, and live in other too when
+// other is given, otherBlock holds other's lumens for the same slots
+void Nova::gatherBlock(const Nova* other, int begin, int end, LumenBlock& block, LumenBlock* otherBlock) const
+{
+    int count = 0;
+    for (int i = begin; i < end; i++)
+    {
+        if (other != nullptr ? !bothLive(*other, i) : isVacant(i)) continue;
+        block.slots[count] = i;
+        lumenAt(i).getValues(block.brightness[count], block.size[count], block.power[count]);
+        if (other != nullptr)
+        {
+            other->lumenAt(i).getValues(otherBlock->brightness[count], otherBlock->size[count], otherBlock->power[count]);
+        }
+        count++;
+    }
+    block.count = count;
+    if (otherBlock != nullptr)
+    {
+        otherBlock->count = count;
+    }
+}
+
+// Helper method for the bulk operators
+// Pre-Condition: Every slot of block is materialized, live and stale
+// Post-Condition: The lumens take the block's values, or only those with changed[k] set when changed is given
+void Nova::scatterBlock(const LumenBlock& block, const unsigned char* changed)
+{
+    for (int k = 0; k < block.count; k++)
+    {
+        if (changed != nullptr && !changed[k]) continue;
+        int slot = block.slots[k];
+        lumens[slot]->setValues(block.brightness[k], block.size[k], block.power[k]);
+        markDirty(slot);
+    }
+}
+
+// Helper method for the bulk operators
+// Pre-Condition: block holds the current values of live allocated slots
+// Post-Condition: Every slot of block is stale, like beginLumenUpdate() on each slot without reading the lumens again
+void Nova::unaccountBlock(const LumenBlock& block)
+{
+    if (fingerprintStale)
+    {
+        return;
+    }
+    for (int k = 0; k < block.count; k++)
+    {
+        int slot = block.slots[k];
+        if (slot < (int)staleFlags.size() && staleFlags[slot]) continue;
+        if (fingerprintStale) return; // markStale() gave up on single slots
+        fingerprint -= slotHash(slot, block.brightness[k], block.size[k], block.power[k]);
+        brightnessSum -= block.brightness[k];
+        sizeSum -= block.size[k];
+        powerSum -= block.power[k];
+        markStale(slot);
+    }
+}
+
+// Helper method for the comparison operators
+// Pre-Condition: Both novas have the same number of slots and no spilled blocks
+// Post-Condition: Returns the first slot that is live in only one nova or holds lumens that aren't equal, -1 if the
+// novas are equal. Slots virtual in both hold the same pattern lumen, so the scan stops once both are virtual
+int Nova::firstDifference(const Nova& other) const
+{
+    // Lumen by lumen, a gather into blocks would read every lumen twice before the first compare. Spilled blocks are
+    // paged in one at a time and each side keeps to its budget after every block it scanned
+    int scanned = std::max(numLumens - virtualCount, other.numLumens - other.virtualCount);
+    for (int begin = 0; begin < scanned; begin += SpillStore::BLOCK_SLOTS)
+    {
+        int end = std::min(begin + SpillStore::BLOCK_SLOTS, scanned);
+        ensureResident(begin, end);
+        other.ensureResident(begin, end);
+        for (int i = begin; i < end; i++)
+        {
+            if (isVacant(i) != other.isVacant(i)) return i;
+            if (isVacant(i)) continue;
+            if (lumenAt(i) != other.lumenAt(i)) return i;
+        }
+        enforceBudget();
+        other.enforceBudget();
+    }
+    return -1;
 }
 
 // Pre-Condition: Throw exception when number of Lumens to glow is greater than the amount nova has or negative number
 // Post-Condtion: Glows specified amount of lumens 
 void Nova::glow(int numLumenGlow)
 {
+    record(OP_GLOW, numLumenGlow);
     if(numLumenGlow > numLumens || numLumenGlow < 0)
     {
         throw std::invalid_argument("Number of lumens to glow exceeds size or below 0");
     }
+    materialize(numLumenGlow);
+    ensureResident(0, numLumenGlow);
 
     replaceUnstableLumens();
     internalRecharge();
     for (int i = 0; i < numLumenGlow; i++)
     {
+        if (isVacant(i)) continue;
+        beginLumenUpdate(i);
+        lumens[i]->glow();
         lumens[i]->glow();
-        int glowVal = lumens[i]->glow();
+        endLumenUpdate(i);
     }
+    enforceBudget();
 }
 
 // Get the minimum glow value across all Lumen subobjects
@@ -166,9 +1380,14 @@ void Nova::glow(int numLumenGlow)
 // Post-condition: Gets the query of the minimum glow without changing states.
 int Nova::getMinGlow()
 {
+    record(OP_MIN_GLOW);
     int minGlow = INT_MAX; // Initialize to maximum possible int value
-    for (int i = 0; i < numLumens; i++)
+    int maxGlow = INT_MIN;
+    patternGlowRange(numLumens - virtualCount, numLumens, minGlow, maxGlow);
+    spilledGlowRange(minGlow, maxGlow);
+    for (int i = 0; i < numLumens - virtualCount; i++)
     {
+        if (isVacant(i)) continue;
         int glow = lumens[i]->glowQuery(); //No state change in Lumen Object, no reduction in power, size or brightness too
         if (glow < minGlow)
         {
@@ -183,9 +1402,14 @@ int Nova::getMinGlow()
 // Post-condition: Gets the query of the maximum glow without changing states.
 int Nova::getMaxGlow()
 {
+    record(OP_MAX_GLOW);
     int maxGlow = INT_MIN; // Initialize to minimum posssible int value
-    for (int i = 0; i < numLumens; i++)
+    int minGlow = INT_MAX;
+    patternGlowRange(numLumens - virtualCount, numLumens, minGlow, maxGlow);
+    spilledGlowRange(minGlow, maxGlow);
+    for (int i = 0; i < numLumens - virtualCount; i++)
     {
+        if (isVacant(i)) continue;
         int glow = lumens[i]->glowQuery(); //No state change in Lumen Object, no reduction in power, size or brightness too  
         if (glow > maxGlow)
         {
@@ -195,31 +1419,147 @@ int Nova::getMaxGlow()
     return maxGlow;
 }
 
+// Glows every slot and queries the result in one pass over the lumens
+// Pre-Condition: None
+// Post-Condition: Same state as glow(getSlotCount()), minGlow and maxGlow are what getMinGlow() and getMaxGlow() return
+// afterwards. Predicts the next tick's recharge decision
+void Nova::tick(int& minGlow, int& maxGlow)
+{
+    if (spillStore != nullptr)
+    {
+        // The spilled blocks have their own glow path, a tick is just the three calls
+        glow(numLumens);
+        minGlow = getMinGlow();
+        maxGlow = getMaxGlow();
+        return;
+    }
+    record(OP_GLOW, numLumens);
+    record(OP_MIN_GLOW);
+    record(OP_MAX_GLOW);
+
+    // Materializing only adds fresh active lumens, which don't change the prediction
+    bool predicted = tickStamp == changeCount;
+    materialize(numLumens);
+    int inactiveCount = tickInactive;
+    int replaced = predicted ? 0 : replaceAndCount(inactiveCount);
+    bool recharge = inactiveCount > liveLumens / 2;
+
+    // Each lumen only depends on the recharge decision, so replacing, recharging, glowing and querying it can be done
+    // together, in slot order instead of stage by stage
+    minGlow = INT_MAX;
+    maxGlow = INT_MIN;
+    int nextInactive = 0;
+    for (int i = 0; i < numLumens; i++)
+    {
+        if (isVacant(i)) continue;
+        Lumen* lumen = lumens[i];
+        beginLumenUpdate(i);
+        if (i >= replaced && lumen->getUnstableCount() > UNSTABLE_THRESHOLD)
+        {
+            lumen->reset();
+        }
+        if (recharge && lumen->isStable())
+        {
+            lumen->recharge();
+        }
+        lumen->glow();
+        lumen->glow();
+        endLumenUpdate(i);
+
+        int glow = lumen->glowQuery();
+        if (glow < minGlow) minGlow = glow;
+        if (glow > maxGlow) maxGlow = glow;
+
+        // The next tick counts inactive lumens after its replace step, so count what that step will leave
+        if (lumen->getUnstableCount() > UNSTABLE_THRESHOLD)
+        {
+            Lumen next(*lumen);
+            next.reset();
+            nextInactive += next.getActive() ? 0 : 1;
+        }
+        else
+        {
+            nextInactive += lumen->getActive() ? 0 : 1;
+        }
+    }
+    tickInactive = nextInactive;
+    tickStamp = changeCount;
+}
+
+// Ticks several novas, each one is streamed through the cache once
+// Pre-Condition: No nova is in the list twice
+// Post-Condition: Every nova is ticked in list order, minGlows[i] and maxGlows[i] hold the glows of novas[i]
+void Nova::tickAll(const std::vector<Nova*>& novas, std::vector<int>& minGlows, std::vector<int>& maxGlows)
+{
+    minGlows.resize(novas.size());
+    maxGlows.resize(novas.size());
+    for (size_t i = 0; i < novas.size(); i++)
+    {
+        novas[i]->tick(minGlows[i], maxGlows[i]);
+    }
+}
+
+// Helper method for tick() when the recharge decision wasn't predicted
+// Pre-Condition: Every slot is allocated or vacant
+// Post-Condition: Replaces unstable lumens block by block and counts the inactive ones, stopping at the first block
+// boundary where the count settles the decision. Returns the slot it stopped at, inactiveCount is the count so far
+int Nova::replaceAndCount(int& inactiveCount)
+{
+    inactiveCount = 0;
+    int uncounted = liveLumens;
+    int end = 0;
+    while (end < numLumens && inactiveCount <= liveLumens / 2 && inactiveCount + uncounted > liveLumens / 2)
+    {
+        int begin = end;
+        end = numLumens - begin > TICK_BLOCK ? begin + TICK_BLOCK : numLumens;
+        for (int i = begin; i < end; i++)
+        {
+            if (isVacant(i)) continue;
+            if (lumens[i]->getUnstableCount() > UNSTABLE_THRESHOLD)
+            {
+                beginLumenUpdate(i);
+                lumens[i]->reset();
+                endLumenUpdate(i);
+            }
+            uncounted--;
+            inactiveCount += lumens[i]->getActive() ? 0 : 1;
+        }
+    }
+    return end;
+}
+
 // Helper method to check if half of lumens is inactive, then internally recharge
 // Pre-condition: None
 // Post-Condition: recharges when more than half of the lumens are inactive.
 void Nova::internalRecharge()
 {
-
+    // Virtual lumens are active and recharging them changes nothing, only allocated slots are visited
     int inactiveCount = 0;
     int rechargeCount = 0;
-    for (int i = 0; i < numLumens; i++)
+    for (int i = 0; i < numLumens - virtualCount; i++)
     {
-        if (!lumens[i]->getActive())
+        if (!isVacant(i) && !lumens[i]->getActive())
         {
             inactiveCount++;
         }
     }
+    for (int b = 0; spillStore != nullptr && b < spillStore->getBlockCount(); b++)
+    {
+        if (spillStore->getBlock(b).spilled) inactiveCount += spillStore->getBlock(b).inactive;
+    }
     
 
     // Recharge lumen subobjects when more than half are inactive
-    if (inactiveCount > numLumens / 2)
+    if (inactiveCount > liveLumens / 2)
     {
-        for (int i = 0; i < numLumens; i++)
+        loadBlocksToChange(true);
+        for (int i = 0; i < numLumens - virtualCount; i++)
         {
-            if (lumens[i]->isStable())
+            if (!isVacant(i) && lumens[i]->isStable())
             {
+                beginLumenUpdate(i);
                 lumens[i]->recharge();
+                endLumenUpdate(i);
                 rechargeCount++;
             }
         }
@@ -230,50 +1570,128 @@ void Nova::internalRecharge()
 // Post-Condition: replace simply resets the lumen objects to its orginal form when its been unstable for 10 times when glow is called
 void Nova::replaceUnstableLumens()
 {
-    for(int i = 0; i < numLumens; i++)
+    loadBlocksToChange(false);
+    for(int i = 0; i < numLumens - virtualCount; i++) // Virtual lumens have never been unstable
     {
-        if(lumens[i]->getUnstableCount() > UNSTABLE_THRESHOLD)
+        if(!isVacant(i) && lumens[i]->getUnstableCount() > UNSTABLE_THRESHOLD)
         {
+            beginLumenUpdate(i);
             lumens[i]->reset();
+            endLumenUpdate(i);
         }
     }
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Returns a new 'Nova' object with 'Lumen' objects that are the result of addition between the current and 'other' objects' lumens
-Nova Nova::operator+(const Nova& other) const {
+Nova Nova::operator+(const Nova& other) const& {
+    record(OP_PLUS, other.numLumens);
     Nova result(*this);
-    for(int i = 0; i < numLumens; ++i) {
-        *result.lumens[i] = *this->lumens[i] + *other.lumens[i];
+    return std::move(result) + other;
+}
+
+// Pre-Condition: Current object is a temporary, 'other' is a valid 'Nova' object
+// Post-Condition: Adds in place and moves the current object's lumens into the result, no lumens are allocated
+Nova Nova::operator+(const Nova& other) && {
+    record(OP_PLUS, other.numLumens);
+    materialize(numLumens);
+    loadAll();
+    other.loadAll();
+    LumenBlock block, otherBlock;
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
+    {
+        gatherBlock(&other, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, &otherBlock);
+        unaccountBlock(block);
+        kernelAddBlock(block, otherBlock);
+        if (kernelAllValid(block))
+        {
+            scatterBlock(block, nullptr);
+            continue;
+        }
+
+        // A sum the Lumen constructor rejects throws from its own slot, after the slots before it were added
+        for (int k = 0; k < block.count; k++)
+        {
+            int i = block.slots[k];
+            beginLumenUpdate(i);
+            *this->lumens[i] = *this->lumens[i] + other.lumenAt(i);
+            endLumenUpdate(i);
+        }
     }
-    return result;
+    other.enforceBudget();
+    return std::move(*this);
 }
 
 // Pre-Condition: None
 // Post-Condition: Returns a new 'Nova' object with 'Lumen' objects that are the result of adding the specified value to each lumen in the current object
-Nova Nova::operator+(int value) const {
+Nova Nova::operator+(int value) const& {
+    record(OP_PLUS_INT, value);
     Nova result(*this);
-    for(int i = 0; i < result.numLumens; i++)
+    return std::move(result) + value;
+}
+
+// Pre-Condition: Current object is a temporary
+// Post-Condition: Adds the value in place and moves the current object's lumens into the result
+Nova Nova::operator+(int value) && {
+    record(OP_PLUS_INT, value);
+    materialize(numLumens);
+    loadAll();
+    LumenBlock block;
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
     {
-        result.lumens + value;
+        gatherBlock(nullptr, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, nullptr);
+        unaccountBlock(block);
+        kernelAddValueBlock(block, value, 0, value);
+        if (kernelAllValid(block))
+        {
+            scatterBlock(block, nullptr);
+            continue;
+        }
+
+        // A negative value can make a lumen the constructor rejects, it throws from its own slot
+        for (int k = 0; k < block.count; k++)
+        {
+            int i = block.slots[k];
+            beginLumenUpdate(i);
+            *this->lumens[i] = *this->lumens[i] + value;
+            endLumenUpdate(i);
+        }
     }
-    return result;
+    return std::move(*this);
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Adds the 'Lumen' objects of 'other' to the current object's lumenss
 Nova& Nova::operator+=(const Nova& other) {
-    for(int i = 0; i < numLumens; ++i) {
-        *this->lumens[i] += *other.lumens[i];
+    record(OP_PLUS_ASSIGN, other.numLumens);
+    materialize(numLumens);
+    loadAll();
+    other.loadAll();
+    LumenBlock block, otherBlock;
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
+    {
+        gatherBlock(&other, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, &otherBlock);
+        unaccountBlock(block);
+        kernelAddBlock(block, otherBlock);
+        scatterBlock(block, nullptr);
     }
+    other.enforceBudget();
     return *this;
 }
 
 // Pre-Condition: None
 // Post-Condition: Increments the brightness, size, and power of each lumen in the current object
 Nova& Nova::operator++() {
-    for(int i = 0; i < numLumens; ++i) {
-        ++(*this->lumens[i]);
+    record(OP_INCREMENT);
+    materialize(numLumens);
+    loadAll();
+    LumenBlock block;
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
+    {
+        gatherBlock(nullptr, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, nullptr);
+        unaccountBlock(block);
+        kernelAddValueBlock(block, 1, 1, 1);
+        scatterBlock(block, nullptr);
     }
     return *this;
 }
@@ -281,19 +1699,29 @@ Nova& Nova::operator++() {
 // Pre-Condition: None
 // Post-Condition: Increments the brightness, size, and power of each lumen in the current object (postfix)
 Nova Nova::operator++(int) {
+    record(OP_POST_INCREMENT);
     Nova copy(*this);
+
+    // The prefix call is part of this call, so it must not be recorded again
+    WorkloadRecorder* attached = recorder;
+    recorder = nullptr;
     ++(*this);
+    recorder = attached;
     return copy;
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Returns true if the current object is equal to 'other', false otherwise
 bool Nova::operator==(const Nova& other) const {
+    record(OP_EQUAL, other.numLumens);
     if (this->numLumens != other.numLumens) return false;
-    for(int i = 0; i < numLumens; ++i) {
-        if (*this->lumens[i] != *other.lumens[i]) return false;
-    }
-    return true;
+    if (virtualCount == 0 && other.virtualCount == 0 && !sameSummary(other)) return false; // Unequal novas almost always differ here, the scan only confirms
+
+    // Slots virtual in both novas hold the same pattern lumen, so the scan stops once both are virtual
+    bool equal = firstDifference(other) < 0;
+    enforceBudget();
+    other.enforceBudget();
+    return equal;
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
@@ -305,50 +1733,96 @@ bool Nova::operator!=(const Nova& other) const {
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Returns true if the current object is greater than 'other', false otherwise
 bool Nova::operator>(const Nova& other) const {
+    record(OP_GREATER, other.numLumens);
     if (this->numLumens != other.numLumens) return this->numLumens > other.numLumens;
-    for(int i = 0; i < numLumens; ++i) {
-        if (*this->lumens[i] != *other.lumens[i]) return *this->lumens[i] > *other.lumens[i];
-    }
-    return false;
+    if (this == &other) return false;
+    int slot = firstDifference(other);
+    if (slot < 0) return false;
+    bool greater;
+    if (isVacant(slot) != other.isVacant(slot)) greater = other.isVacant(slot); // A lumen outranks a vacant slot
+    else greater = lumenAt(slot) > other.lumenAt(slot);
+    enforceBudget();
+    other.enforceBudget();
+    return greater;
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Returns true if the current object is less than 'other', false otherwise
 bool Nova::operator<(const Nova& other) const {
+    record(OP_LESS, other.numLumens);
     if (this->numLumens != other.numLumens) return this->numLumens < other.numLumens;
-    for(int i = 0; i < numLumens; ++i) {
-        if (*this->lumens[i] != *other.lumens[i]) return *this->lumens[i] < *other.lumens[i];
-    }
-    return false;
+    if (this == &other) return false;
+    int slot = firstDifference(other);
+    if (slot < 0) return false;
+    bool less;
+    if (isVacant(slot) != other.isVacant(slot)) less = isVacant(slot); // A vacant slot ranks below a lumen
+    else less = lumenAt(slot) < other.lumenAt(slot);
+    enforceBudget();
+    other.enforceBudget();
+    return less;
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Returns a new 'Nova' object with 'Lumen' objects that are the result of subtraction between the current and 'other' objects' lumens
-Nova Nova::operator-(const Nova& other) const {
+Nova Nova::operator-(const Nova& other) const& {
+    record(OP_MINUS, other.numLumens);
     Nova result(*this);
-    for(int i = 0; i < numLumens; ++i) {
-        if((*this->lumens[i] > *other.lumens[i]) )
-        {
-            *result.lumens[i] = *this->lumens[i] - *other.lumens[i];
-        }
+    return std::move(result) - other;
+}
+
+// Pre-Condition: Current object is a temporary, 'other' is a valid 'Nova' object
+// Post-Condition: Subtracts in place and moves the current object's lumens into the result, no lumens are allocated
+Nova Nova::operator-(const Nova& other) && {
+    record(OP_MINUS, other.numLumens);
+    materialize(numLumens);
+    loadAll();
+    other.loadAll();
+    // Only lumens greater than their counterpart change, so the clamp at 0 of Lumen::operator- never applies
+    LumenBlock block, otherBlock;
+    unsigned char changed[LumenBlock::CAPACITY];
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
+    {
+        gatherBlock(&other, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, &otherBlock);
+        unaccountBlock(block);
+        kernelSubtractWhereGreater(block, otherBlock, changed);
+        scatterBlock(block, changed);
     }
-    return result;
+    other.enforceBudget();
+    return std::move(*this);
 }
 
 // Pre-Condition: Assumes that 'other' is a valid 'Nova' object
 // Post-Condition: Subtracts the 'Lumen' objects of 'other' from the current object's lumens
 Nova& Nova::operator-=(const Nova& other) {
-    for(int i = 0; i < numLumens; ++i) {
-        *this->lumens[i] -= *other.lumens[i];
+    record(OP_MINUS_ASSIGN, other.numLumens);
+    materialize(numLumens);
+    loadAll();
+    other.loadAll();
+    LumenBlock block, otherBlock;
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
+    {
+        gatherBlock(&other, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, &otherBlock);
+        unaccountBlock(block);
+        kernelSubtractBlock(block, otherBlock);
+        scatterBlock(block, nullptr);
     }
+    other.enforceBudget();
     return *this;
 }
 
 // Pre-Condition: None
 // Post-Condition: Decrements the brightness, size, and power of each lumen in the current object
 Nova& Nova::operator--() {
-    for(int i = 0; i < numLumens; ++i) {
-        --(*this->lumens[i]);
+    record(OP_DECREMENT);
+    materialize(numLumens);
+    loadAll();
+    LumenBlock block;
+    for (int begin = 0; begin < numLumens; begin += LumenBlock::CAPACITY)
+    {
+        gatherBlock(nullptr, begin, std::min(begin + LumenBlock::CAPACITY, numLumens), block, nullptr);
+        unaccountBlock(block);
+        kernelAddValueBlock(block, -1, -1, -1);
+        scatterBlock(block, nullptr);
     }
     return *this;
 }
@@ -356,8 +1830,14 @@ Nova& Nova::operator--() {
 // Pre-Condition: None
 // Post-Condition: Decrements the brightness, size, and power of each lumen in the current object (postfix)
 Nova Nova::operator--(int) {
+    record(OP_POST_DECREMENT);
     Nova copy(*this);
+
+    // The prefix call is part of this call, so it must not be recorded again
+    WorkloadRecorder* attached = recorder;
+    recorder = nullptr;
     --(*this);
+    recorder = attached;
     return copy;
 }
 
@@ -373,6 +1853,65 @@ Nova Nova::operator--(int) {
  * Replacing is simply resetting the lumen object back to its original, by implementing a unstable count
  * in lumen and using an unstable threshold in nova.
  * Generate numbers for the remaining lumen objects by a pattern
+ * Removed lumens leave a nullptr in their slot, the slot index is pushed on a free list and reused by the next add,
+ * so slot indices held by clients never shift. The array doubles when full for amortized O(1) adds.
+ * Element-wise operators skip slots that are vacant in either nova. They gather blocks of LumenBlock::CAPACITY slots
+ * into contiguous arrays, run a kernel from lumenkernels.cpp over them and write back only the lumens the scalar loop
+ * would have updated. The old values are taken out of the fingerprint and sums from the gathered block before the
+ * kernel runs, so writing a lumen back only marks it dirty.
+ * + checks its results with kernelAllValid() and replays a failing block through the Lumen operators, which throw
+ * from the same slot the scalar loop did.
+ * The const& overloads of + and - copy once and forward to the && overloads, which work in place on the temporary
+ * and move it out, so chains like a + b - c allocate lumens only for the first copy.
+ * The move constructor and move assignment are noexcept so std::vector<Nova> and std::sort move instead of copying.
+ * Move assignment swaps the lumens but leaves the memory budget, the shared segment and the command queue with each
+ * object, so it never has to refuse a pair of modes. Both sides load their spilled blocks before the swap and spill
+ * again under their own budget afterwards; only an unreadable spill file can fail there, and it ends the program.
+ * Copy assignment keeps the target's own modes too.
+ * Every method that changes a lumen or a slot marks the slot dirty. A flag per slot keeps the dirty list free of duplicates,
+ * so a checkpoint costs time proportional to the slots that changed rather than to the size of the nova.
+ * Copies and assignments replace the state as a whole and set fullFrameDue instead, so the next checkpoint writes a
+ * full frame and a journal never keeps records of slots the old state had.
+ * The recorder belongs to the object it was attached to: copies and moves don't carry it, and internal calls
+ * (growth inside addLumen, the prefix call inside postfix ++ and --, the && overloads on a fresh copy) are not logged.
+ * operator!= is logged as the operator== it calls.
+ * The fingerprint is a wrapping sum of one hash per live slot, each over the slot index, brightness, size and power,
+ * so a lumen change is applied by subtracting its old hash and adding the new one. Every mutation goes through
+ * beginLumenUpdate/endLumenUpdate to keep the fingerprint, the sums and the dirty list in step. Adding the new hash
+ * is lazy: beginLumenUpdate takes the old values out and files the slot as stale, and getFingerprint and hash count
+ * the stale slots again before reading. Once an eighth of the slots are stale, as in any glow() of
+ * most of the nova, the fingerprint as a whole is marked stale instead and updates stop hashing altogether; the next
+ * read recounts every slot in parallel chunks. A slot changed many times between reads is then hashed once per read
+ * instead of twice per change. With a memory budget the recount couldn't see spilled lumens, so only single slots go
+ * stale, and spilling counts them first since a spilled slot holds nullptr.
+ * operator== returns false in O(1) when the slot counts, live counts, fingerprints or sums differ and only scans
+ * the lumens to confirm a match. It only trusts a summary with nothing left to count: bringing one up to date after
+ * a glow recounts every slot, while the scan of an unequal pair usually stops within a few slots. > and < still scan, since they are decided by the first differing lumen. The scan
+ * compares lumen pointers pair by pair instead of gathering blocks for a kernel: an equal pair of novas has to be
+ * read in full either way, and the gather only added a second pass over every lumen.
+ * Generated lumens only depend on their slot index, so the constructor, copies and releaseLumens() split the slots
+ * into chunks on the thread pool. The fingerprint and sums are added up per chunk and merged under a lock, the
+ * wrapping sum gives the same result in any order.
+ * A lazy nova only allocates slot 0 and leaves the last virtualCount slots virtual. Their lumens are the generated
+ * pattern, which repeats every 400 slots, so queries read one shared table and getMinGlow()/getMaxGlow() cover the
+ * virtual slots by visiting at most one period. Every change first calls materialize() up to the highest slot it
+ * touches, which copies the pattern into real lumens without changing the nova's state, so mutating code never sees
+ * a virtual slot. Virtual lumens are active and have never been unstable, so replace and recharge skip them.
+ * Virtual slots are always the trailing ones, so an appended slot would have to come after all of them. addLumen()
+ * throws instead of allocating the whole tail for one lumen, and a nova whose slots were all allocated by glows or
+ * operators appends normally.
+ * A spilled slot holds nullptr like a vacant one, so loops over allocated slots skip it. Lumens in spilled blocks
+ * stay counted in the fingerprint, sums and live count. Public calls load what they touch first with
+ * ensureResident(), except that glow() only loads blocks whose summary shows replace or recharge would change a
+ * lumen, and the queries read each spilled block's saved glow range. Whole-nova operators load every block of the
+ * nova they change, and its next glow() spills again. A nova that is only read, the source of a copy or the right
+ * hand side of an operator, spills again as soon as the call is done, and comparisons and checkpoints page blocks in
+ * one at a time, spilling as they go.
+ * tick() needs the inactive count after every replace before it can recharge any lumen. It either reuses the count
+ * its last pass predicted, valid when changeCount hasn't moved since, or replaces and counts only until the count can
+ * no longer cross half of the live lumens, so the fused pass skips replacing the slots that were already counted.
+ * Every change to a slot goes through markDirty(), which also marks it for the shared segment. Replacing the state
+ * as a whole, by copy or move assignment, marks the segment for a full publish instead.
  * getMinGlow() and getMaxGlow() only gets the query but does not change the state and properties of lumen object.
  * Support addition for both types, including
     a. standard addition
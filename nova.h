@@ -4,6 +4,7 @@
  * This file creates a class nova that supports deep copying, move semantics, glows as well as queries for minimum glow and maximum glow,
  * this class will also internally recharge its lumen objects when more than half of lumen object in nova is inactive and also replace persistenly
  * unstable lumen objects if they reach beyond the unstable threshold count
+ * A nova holds Lumen, the lumen of the policy the program was built with (LUMEN_POLICY in lumen.h)
  * 
  */
 
@@ -11,6 +12,17 @@
 #define NOVA_H
 
 #include "lumen.h"
+#include "spill.h"
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+class WorkloadRecorder;
+class ThreadPool;
+class SharedNovaSegment;
+class NovaCommandQueue;
+struct LumenBlock;
 
 /* Class Invariants:
     * 1) size, power and brightness should never be negative
@@ -27,26 +39,74 @@
         b. mixed-mode addition
         c. ++
         d. short-cut assignment
+    * 11) Lumen slots are stable: removing a lumen leaves its slot vacant and the slot is reused by a later add
+    * 12) Capacity grows geometrically so adding a lumen is amortized O(1)
+    * 13) Arithmetic on a temporary nova reuses its lumens instead of allocating new ones
+    * 14) Every slot changed since the last checkpoint is marked dirty, a new nova starts with every slot dirty and a
+    *     nova whose state was replaced by a copy or an assignment counts every slot dirty until its next checkpoint
+    * 15) Public calls are logged only while a recorder is attached
+    * 16) The fingerprint and the brightness, size and power sums match the current lumens once the stale slots are
+    *     counted again, or once they are recounted in full when the whole fingerprint is stale. getFingerprint() and
+    *     hash() bring them up to date first, operator== only reads them when they already are
+    * 17) With a thread pool attached, construction, deep copies and destruction split the slots across its threads
+    *     and end in the same state as without one
+    * 18) A lazy nova keeps its trailing pattern lumens virtual, a slot is allocated the first time its lumen changes.
+    *     addLumen() only reuses vacant slots until no slot is virtual
+    * 19) Under a memory budget, cold blocks of lumens live in a spill file and are paged back in before they are used
+    * 20) With shared memory on, every slot changed since the last publish is written to the segment on the next one
+    * 21) Commands queued by other threads only run inside drainCommands(), on the thread that owns the nova
+    * 22) Element-wise operators run as bulk kernels over gathered blocks and give the same lumens, dirty slots and
+    *     exceptions as applying the Lumen operators one slot at a time
+    * 23) tick() ends in the same state and returns the same glows as glow(getSlotCount()), getMinGlow() and
+    *     getMaxGlow(), the recharge decision it predicts for the next tick only holds while no slot changed since
 */
 
 class Nova
 {
 public:
     Nova(int brightness, int size, int power, int numLumens, Lumen** lumensInject);
+    Nova(int brightness, int size, int power, int numLumens, Lumen** lumensInject, ThreadPool* pool);
+    static Nova createLazy(int brightness, int size, int power, int numLumens);
     Nova() = default;
     ~Nova();
     void glow(int numLumens);
     int getMinGlow();
     int getMaxGlow();
+    void tick(int& minGlow, int& maxGlow);
+    static void tickAll(const std::vector<Nova*>& novas, std::vector<int>& minGlows, std::vector<int>& maxGlows);
+
+    int addLumen(int brightness, int size, int power);
+    int addLumen(Lumen* lumen);
+    void removeLumen(int slot);
+    void reserve(int newCapacity);
+    int getLumenCount() const;
+    int getSlotCount() const;
+    int getCapacity() const;
+    int getDirtyCount() const;
+    void setRecorder(WorkloadRecorder* recorder);
+    unsigned long long getFingerprint() const;
+    size_t hash() const;
+    void setThreadPool(ThreadPool* pool);
+    int getMaterializedCount() const;
+    void setMemoryBudget(long long bytes, const std::string& spillPath);
+    long long getMemoryFootprint() const;
+    SpillStats getSpillStats() const;
+    void setSharedMemory(const std::string& name);
+    void publishShared();
+    void setCommandQueue(int capacity);
+    NovaCommandQueue* getCommandQueue() const;
+    int drainCommands(int maxCommands);
 
     Nova(const Nova& other); // Copy constructor
     Nova& operator=(const Nova& other); // Copy assignment operator
 
-    Nova(Nova&& other); // Move constructor
-    Nova& operator=(Nova&& other); // Move assignment operator
+    Nova(Nova&& other) noexcept; // Move constructor
+    Nova& operator=(Nova&& other) noexcept; // Move assignment operator
 
-    Nova operator+(const Nova& other) const;
-    Nova operator+(int value) const;
+    Nova operator+(const Nova& other) const&;
+    Nova operator+(const Nova& other) &&;
+    Nova operator+(int value) const&;
+    Nova operator+(int value) &&;
     Nova& operator+=(const Nova& other);
     Nova& operator++();
     Nova operator++(int);
@@ -54,7 +114,8 @@ public:
     bool operator!=(const Nova& other) const;
     bool operator>(const Nova& other) const;
     bool operator<(const Nova& other) const;
-    Nova operator-(const Nova& other) const;
+    Nova operator-(const Nova& other) const&;
+    Nova operator-(const Nova& other) &&;
     Nova& operator-=(const Nova& other);
     Nova& operator--();
     Nova operator--(int);
@@ -64,11 +125,92 @@ public:
 
 
 private:
-    Lumen** lumens; // Dynamic array of Lumen* pointers
-    int numLumens; // Number of lumens in the array
+    Lumen** lumens = nullptr; // Dynamic array of Lumen* pointers, nullptr marks a vacant slot
+    int numLumens = 0; // Number of slots in use, including vacant ones
+    int liveLumens = 0; // Number of slots holding a lumen
+    int capacity = 0; // Number of slots allocated for the array
+    std::vector<int> freeSlots; // Vacant slots waiting to be reused
+    std::vector<unsigned char> dirtyFlags; // One flag per slot, set when the slot changed since the last checkpoint
+    std::vector<int> dirtySlots; // Slots whose flag is set, in the order they first changed
+    WorkloadRecorder* recorder = nullptr; // Not owned, stays with this object on copy and move
+    mutable unsigned long long fingerprint = 0; // Wrapping sum of lumenHash() over live allocated slots that aren't stale
+    mutable long long brightnessSum = 0;
+    mutable long long sizeSum = 0;
+    mutable long long powerSum = 0;
+    mutable std::vector<unsigned char> staleFlags; // One flag per slot, set while the slot is left out of the fingerprint
+    mutable std::vector<int> staleSlots; // Slots whose stale flag is set
+    mutable bool fingerprintStale = false; // Too many slots went stale, the fingerprint and sums are recounted in full
+    ThreadPool* threadPool = nullptr; // Not owned, copied and moved along with the lumens
+    int virtualCount = 0; // Trailing slots whose lumen is still the constructor's pattern and isn't allocated
+    bool virtualDirty = false; // The virtual slots haven't been checkpointed yet
+    bool fullFrameDue = false; // The state was replaced as a whole, the next checkpoint has to write every slot
+    mutable unsigned long long virtualFingerprint = 0; // Fingerprint share of the virtual slots, computed on first use
+    mutable bool virtualFingerprintValid = false;
+    SpillStore* spillStore = nullptr; // Owned, only set while a memory budget is on, stays with this object on copy and move assignment
+    SharedNovaSegment* sharedSegment = nullptr; // Owned, readers know it by name so it stays with this object on copy and move
+    NovaCommandQueue* commandQueue = nullptr; // Owned, producers hold it by pointer so it stays with this object on copy and move
+    long long changeCount = 0; // Bumped by markDirty(), every change to a slot goes through it
+    long long tickStamp = -1; // changeCount right after the last tick(), -1 once the state was replaced
+    int tickInactive = 0; // Inactive lumens the next tick's recharge decision counts, valid while tickStamp matches
     void internalRecharge();
     void replaceUnstableLumens();
+    bool isVacant(int slot) const;
+    bool bothLive(const Nova& other, int slot) const;
+    void markDirty(int slot);
+    void accountLumen(int slot) const;
+    void unaccountLumen(int slot);
+    void markStale(int slot);
+    void refreshFingerprint() const;
+    void beginLumenUpdate(int slot);
+    void endLumenUpdate(int slot);
+    unsigned long long lumenHash(int slot) const;
+    static unsigned long long mixHash(unsigned long long value);
+    bool sameSummary(const Nova& other) const;
+    int replaceAndCount(int& inactiveCount);
+    void clearDirty();
+    void runParallel(int count, const std::function<void(int, int)>& body) const;
+    void copyLumens(const Nova& other);
+    void accountAllLumens() const;
+    static Lumen* generateLumen(int slot);
+    static Lumen& patternLumen(int slot);
+    static void patternGlowRange(int begin, int end, int& minGlow, int& maxGlow);
+    void materialize(int end);
+    const Lumen& lumenAt(int slot) const;
+    static unsigned long long slotHash(int slot, const Lumen& lumen);
+    static unsigned long long slotHash(int slot, int brightness, int size, int power);
+    void gatherBlock(const Nova* other, int begin, int end, LumenBlock& block, LumenBlock* otherBlock) const;
+    void scatterBlock(const LumenBlock& block, const unsigned char* changed);
+    void unaccountBlock(const LumenBlock& block);
+    int firstDifference(const Nova& other) const;
+    void ensureResident(int begin, int end) const;
+    void loadAll() const;
+    void loadBlocks(const std::vector<int>& blocks) const;
+    void loadBlocksToChange(bool forRecharge) const;
+    void spilledGlowRange(int& minGlow, int& maxGlow) const;
+    void enforceBudget() const;
+
+    friend class CheckpointJournal;
+    friend class NovaSimulator;
+    void releaseLumens();
+    void grow(int newCapacity);
+    void record(int op, int arg0 = 0, int arg1 = 0, int arg2 = 0) const;
     const int UNSTABLE_THRESHOLD = 24;
+    static const int PARALLEL_GRAIN = 16384; // Slots per chunk handed to a pool thread
+    static const int PATTERN_PERIOD = 400; // The generated lumen of slot i only depends on i % PATTERN_PERIOD
+    static const int COMMAND_BATCH = 64; // Commands popped from the queue and completed together
+    static const int TICK_BLOCK = 4096; // Slots replaced and counted between checks of the recharge decision
 };
 
+// Lets novas be used as keys of unordered containers
+namespace std
+{
+    template<> struct hash<Nova>
+    {
+        size_t operator()(const Nova& nova) const
+        {
+            return nova.hash();
+        }
+    };
+}
+
 #endif
\ No newline at end of file
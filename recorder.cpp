@@ -0,0 +1,255 @@
+/*
+ * recorder.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements the workload recorder and reader. A workload file starts with the magic "NVWL" and a
+ * version byte, followed by one entry per call:
+ *
+ *     op byte, varint nanoseconds since the previous call, zigzag varint per argument
+ *
+ * A glow(n) call therefore usually takes 3 to 6 bytes. The recorder keeps entries in a buffer and writes it in blocks
+ * so recording doesn't add a system call to every nova method.
+ *
+ * ASSUMPTIONS:
+ *  1) The clock is monotonic, so the time between calls is never negative.
+ *  2) Reader and recorder agree on the argument count of every op.
+ *
+*/
+
+#include "recorder.h"
+#include <chrono>
+#include <stdexcept>
+using namespace std;
+
+namespace
+{
+    const char WORKLOAD_MAGIC[4] = { 'N', 'V', 'W', 'L' };
+    const unsigned char WORKLOAD_VERSION = 1;
+    const size_t FLUSH_BYTES = 64 * 1024;
+
+    long long nowNanos()
+    {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Zigzag keeps small negative arguments small once varint encoded
+    unsigned long long zigzag(int value)
+    {
+        return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+    }
+
+    int unzigzag(unsigned long long value)
+    {
+        unsigned int bits = (unsigned int)value;
+        return (int)((bits >> 1) ^ (0u - (bits & 1u)));
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns a readable name for the op, "unknown" if it isn't one
+const char* workloadOpName(int op)
+{
+    switch (op)
+    {
+        case OP_GLOW: return "glow";
+        case OP_MIN_GLOW: return "getMinGlow";
+        case OP_MAX_GLOW: return "getMaxGlow";
+        case OP_ADD_LUMEN: return "addLumen";
+        case OP_REMOVE_LUMEN: return "removeLumen";
+        case OP_RESERVE: return "reserve";
+        case OP_PLUS: return "operator+";
+        case OP_PLUS_INT: return "operator+(int)";
+        case OP_PLUS_ASSIGN: return "operator+=";
+        case OP_MINUS: return "operator-";
+        case OP_MINUS_ASSIGN: return "operator-=";
+        case OP_INCREMENT: return "operator++";
+        case OP_POST_INCREMENT: return "operator++(int)";
+        case OP_DECREMENT: return "operator--";
+        case OP_POST_DECREMENT: return "operator--(int)";
+        case OP_EQUAL: return "operator==";
+        case OP_GREATER: return "operator>";
+        case OP_LESS: return "operator<";
+        case OP_COPY_ASSIGN: return "operator=";
+        case OP_MOVE_ASSIGN: return "operator=(&&)";
+        case OP_RECHARGE: return "recharge";
+        case OP_RESET: return "reset";
+        default: return "unknown";
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns how many arguments are stored with the op
+int workloadOpArgCount(int op)
+{
+    switch (op)
+    {
+        case OP_ADD_LUMEN: return 3;
+        case OP_GLOW:
+        case OP_REMOVE_LUMEN:
+        case OP_RESERVE:
+        case OP_PLUS:
+        case OP_PLUS_INT:
+        case OP_PLUS_ASSIGN:
+        case OP_MINUS:
+        case OP_MINUS_ASSIGN:
+        case OP_EQUAL:
+        case OP_GREATER:
+        case OP_LESS:
+        case OP_COPY_ASSIGN:
+        case OP_MOVE_ASSIGN: return 1;
+        default: return 0;
+    }
+}
+
+// Pre-Condition: path names a file that can be created
+// Post-Condition: Creates the file and writes its header, throws if it can't be opened
+WorkloadRecorder::WorkloadRecorder(const std::string& path)
+    : out(path, ios::binary | ios::trunc), startNanos(nowNanos()), lastNanos(startNanos), eventCount(0)
+{
+    if (!out)
+    {
+        throw std::runtime_error("Could not open workload file for writing");
+    }
+    out.write(WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC));
+    out.put((char)WORKLOAD_VERSION);
+    buffer.reserve(FLUSH_BYTES + 64);
+}
+
+// Pre-Condition: None
+// Post-Condition: Writes the buffered calls before closing the file
+WorkloadRecorder::~WorkloadRecorder()
+{
+    flush();
+}
+
+// Pre-Condition: op is a WorkloadOp, unused arguments are ignored
+// Post-Condition: Appends the call with the time since the previous call
+void WorkloadRecorder::record(int op, int arg0, int arg1, int arg2)
+{
+    long long now = nowNanos();
+    buffer.push_back((unsigned char)op);
+    putVarint((unsigned long long)(now - lastNanos));
+    lastNanos = now;
+
+    int argCount = workloadOpArgCount(op);
+    if (argCount > 0) putVarint(zigzag(arg0));
+    if (argCount > 1) putVarint(zigzag(arg1));
+    if (argCount > 2) putVarint(zigzag(arg2));
+    eventCount++;
+
+    if (buffer.size() >= FLUSH_BYTES)
+    {
+        flush();
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Buffered calls are written to the file
+void WorkloadRecorder::flush()
+{
+    if (!buffer.empty())
+    {
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        buffer.clear();
+    }
+    out.flush();
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns how many calls were recorded
+long long WorkloadRecorder::getEventCount() const
+{
+    return eventCount;
+}
+
+// Helper method for LEB128 encoding
+// Pre-Condition: None
+// Post-Condition: Appends value 7 bits at a time, the high bit marks that more bytes follow
+void WorkloadRecorder::putVarint(unsigned long long value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((unsigned char)value);
+}
+
+// Pre-Condition: path names a workload file
+// Post-Condition: Opens the file and checks its header, throws if it isn't a workload file
+WorkloadReader::WorkloadReader(const std::string& path)
+    : in(path, ios::binary), timestamp(0)
+{
+    char magic[sizeof(WORKLOAD_MAGIC)];
+    if (!in || !in.read(magic, sizeof(magic)) || string(magic, sizeof(magic)) != string(WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC)))
+    {
+        throw std::runtime_error("Not a workload file");
+    }
+    if (in.get() != WORKLOAD_VERSION)
+    {
+        throw std::runtime_error("Unsupported workload file version");
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Fills event with the next call and returns true, returns false at the end of the file
+bool WorkloadReader::next(WorkloadEvent& event)
+{
+    int op = in.get();
+    if (op == EOF)
+    {
+        return false;
+    }
+
+    unsigned long long delta;
+    if (!getVarint(delta))
+    {
+        return false;
+    }
+    timestamp += (long long)delta;
+
+    event.op = op;
+    event.timestamp = timestamp;
+    event.args[0] = event.args[1] = event.args[2] = 0;
+    int argCount = workloadOpArgCount(op);
+    for (int i = 0; i < argCount; i++)
+    {
+        unsigned long long value;
+        if (!getVarint(value))
+        {
+            return false;
+        }
+        event.args[i] = unzigzag(value);
+    }
+    return true;
+}
+
+// Helper method for LEB128 decoding
+// Pre-Condition: None
+// Post-Condition: Returns false if the file ends inside the varint
+bool WorkloadReader::getVarint(unsigned long long& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = in.get();
+        if (byte == EOF)
+        {
+            return false;
+        }
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * Timestamps are stored as deltas so each one is usually one or two bytes.
+ * Arguments are zigzag encoded because operator+(int) can take a negative value.
+ * The reader rebuilds absolute timestamps by summing the deltas.
+ */
@@ -0,0 +1,100 @@
+/*
+ * recorder.h
+ *
+ * This file creates a class WorkloadRecorder that logs the calls made on a nova, with their arguments and the time
+ * they were made, to a compact binary file, and a class WorkloadReader that reads such a file back. Recording is
+ * opt-in: a nova only logs while a recorder is attached with Nova::setRecorder().
+ *
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Operations a nova logs, stored as one byte per call
+enum WorkloadOp
+{
+    OP_GLOW = 1,
+    OP_MIN_GLOW,
+    OP_MAX_GLOW,
+    OP_ADD_LUMEN,
+    OP_REMOVE_LUMEN,
+    OP_RESERVE,
+    OP_PLUS,
+    OP_PLUS_INT,
+    OP_PLUS_ASSIGN,
+    OP_MINUS,
+    OP_MINUS_ASSIGN,
+    OP_INCREMENT,
+    OP_POST_INCREMENT,
+    OP_DECREMENT,
+    OP_POST_DECREMENT,
+    OP_EQUAL,
+    OP_GREATER,
+    OP_LESS,
+    OP_COPY_ASSIGN,
+    OP_MOVE_ASSIGN,
+    OP_RECHARGE, // A queued recharge run by drainCommands()
+    OP_RESET, // A queued reset run by drainCommands()
+    OP_COUNT
+};
+
+const char* workloadOpName(int op);
+int workloadOpArgCount(int op);
+
+// One call read back from a workload file
+struct WorkloadEvent
+{
+    int op;
+    long long timestamp; // Nanoseconds since the recorder was created
+    int args[3];
+};
+
+/* Class Invariants:
+    * 1) Each call is stored as the op byte, the time since the previous call and the op's arguments, all as varints
+    * 2) Calls are buffered and written in blocks, the destructor writes what is left
+    * 3) A recorder is not thread safe, like the nova it records
+*/
+
+class WorkloadRecorder
+{
+public:
+    explicit WorkloadRecorder(const std::string& path);
+    ~WorkloadRecorder();
+    void record(int op, int arg0 = 0, int arg1 = 0, int arg2 = 0);
+    void flush();
+    long long getEventCount() const;
+
+private:
+    std::ofstream out;
+    std::vector<unsigned char> buffer;
+    long long startNanos;
+    long long lastNanos;
+    long long eventCount;
+    void putVarint(unsigned long long value);
+
+    WorkloadRecorder(const WorkloadRecorder&) = delete;
+    WorkloadRecorder& operator=(const WorkloadRecorder&) = delete;
+};
+
+/* Class Invariants:
+    * 1) Events are returned in the order they were recorded
+    * 2) A file cut short ends at the last complete event
+*/
+
+class WorkloadReader
+{
+public:
+    explicit WorkloadReader(const std::string& path);
+    bool next(WorkloadEvent& event);
+
+private:
+    std::ifstream in;
+    long long timestamp;
+    bool getVarint(unsigned long long& value);
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * replay.cpp
+ * Date: 10/18/2026
+ *
+ * Description:
+ * This tool replays a workload recorded with WorkloadRecorder against a nova restored from a checkpoint journal.
+ * Calls are issued back to back, ignoring the recorded gaps between them, and each call is timed. At the end it
+ * reports the throughput and a latency histogram for every kind of call.
+ *
+ * Usage:
+ *     replay <workload file> <checkpoint journal>
+ *
+ * The journal should hold the nova as it was when recording started. Recordings don't capture the right hand side
+ * of binary operators, so those calls use a copy of the restored nova with the same slots, which does the same
+ * amount of work. The result of the last + or - is kept so a following move assignment can move it into the nova, as
+ * in nova = nova + other. Queued recharges and resets are replayed through a command queue on the restored nova.
+ * Calls that fail because the replayed state drifted from the recorded one are counted and skipped.
+ *
+ */
+
+#include "nova.h"
+#include "commandqueue.h"
+#include "checkpoint.h"
+#include "recorder.h"
+#include "histogram.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+volatile int sink; // Keeps query results from being optimized away
+
+// Runs one recorded call against the nova, operand stands in for the other side of binary operators and result keeps
+// the last nova a binary operator returned
+void replayEvent(const WorkloadEvent& event, Nova& nova, const Nova& operand, Nova& result)
+{
+    switch (event.op)
+    {
+        case OP_GLOW: nova.glow(event.args[0]); break;
+        case OP_MIN_GLOW: sink = nova.getMinGlow(); break;
+        case OP_MAX_GLOW: sink = nova.getMaxGlow(); break;
+        case OP_ADD_LUMEN: nova.addLumen(event.args[0], event.args[1], event.args[2]); break;
+        case OP_REMOVE_LUMEN: nova.removeLumen(event.args[0]); break;
+        case OP_RESERVE: nova.reserve(event.args[0]); break;
+        case OP_PLUS: result = nova + operand; sink = result.getSlotCount(); break;
+        case OP_PLUS_INT: result = nova + event.args[0]; sink = result.getSlotCount(); break;
+        case OP_PLUS_ASSIGN: nova += operand; break;
+        case OP_MINUS: result = nova - operand; sink = result.getSlotCount(); break;
+        case OP_MINUS_ASSIGN: nova -= operand; break;
+        case OP_INCREMENT: ++nova; break;
+        case OP_POST_INCREMENT: nova++; break;
+        case OP_DECREMENT: --nova; break;
+        case OP_POST_DECREMENT: nova--; break;
+        case OP_EQUAL: sink = (nova == operand); break;
+        case OP_GREATER: sink = (nova > operand); break;
+        case OP_LESS: sink = (nova < operand); break;
+        case OP_COPY_ASSIGN: nova = operand; break;
+        case OP_MOVE_ASSIGN:
+            // Anything else that was moved in wasn't recorded, a copy of the operand stands in for it
+            if (result.getSlotCount() == event.args[0]) nova = std::move(result);
+            else nova = operand;
+            break;
+        case OP_RECHARGE: nova.getCommandQueue()->push({CMD_RECHARGE, 0}); nova.drainCommands(1); break;
+        case OP_RESET: nova.getCommandQueue()->push({CMD_RESET, 0}); nova.drainCommands(1); break;
+        default: throw std::invalid_argument("Unknown workload op");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: replay <workload file> <checkpoint journal>" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        CheckpointJournal journal(argv[2]);
+        Nova nova = journal.replay();
+        Nova operand(nova);
+        Nova result;
+        nova.setCommandQueue(1);
+        std::cout << "Restored nova with " << nova.getLumenCount() << " lumens in " << nova.getSlotCount() << " slots" << std::endl;
+
+        WorkloadReader reader(argv[1]);
+        std::vector<LatencyHistogram> histograms(OP_COUNT);
+        WorkloadEvent event;
+        long long events = 0;
+        long long failed = 0;
+        long long recordedNanos = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        while (reader.next(event))
+        {
+            if (event.op <= 0 || event.op >= OP_COUNT)
+            {
+                std::cerr << "Stopping at unknown op " << event.op << std::endl;
+                break;
+            }
+
+            chrono::steady_clock::time_point before = chrono::steady_clock::now();
+            try
+            {
+                replayEvent(event, nova, operand, result);
+            }
+            catch (const std::invalid_argument&)
+            {
+                failed++;
+            }
+            chrono::steady_clock::time_point after = chrono::steady_clock::now();
+
+            histograms[event.op].record(chrono::duration_cast<chrono::nanoseconds>(after - before).count());
+            recordedNanos = event.timestamp;
+            events++;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        std::cout << "Replayed " << events << " calls in " << seconds << " s (recorded over " << recordedNanos / 1e9 << " s)" << std::endl;
+        std::cout << "Throughput: " << (seconds > 0 ? events / seconds : 0) << " calls/s, failed calls: " << failed << std::endl;
+        std::cout << std::left << std::setw(18) << "op" << std::right
+                  << std::setw(10) << "count" << std::setw(12) << "mean ns" << std::setw(12) << "p50 ns"
+                  << std::setw(12) << "p99 ns" << std::setw(12) << "p99.9 ns" << std::setw(12) << "max ns" << std::endl;
+        for (int op = 1; op < OP_COUNT; op++)
+        {
+            const LatencyHistogram& h = histograms[op];
+            if (h.getCount() == 0) continue;
+            std::cout << std::left << std::setw(18) << workloadOpName(op) << std::right
+                      << std::setw(10) << h.getCount() << std::setw(12) << (long long)h.getMean()
+                      << std::setw(12) << h.getPercentile(50) << std::setw(12) << h.getPercentile(99)
+                      << std::setw(12) << h.getPercentile(99.9) << std::setw(12) << h.getMax() << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "replay: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,453 @@
+/*
+ * sharednova.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements the shared memory segment of a nova and its readers. The segment starts with a header
+ * holding a sequence number and the slot count, the slots follow at a fixed offset as plain LumenState values.
+ * The writer uses a sequence lock: it makes the sequence odd, writes the slots changed since its last publish, and
+ * makes it even again. A reader copies what it needs, computes its answer, and keeps it only if the sequence was the
+ * same even number before and after, otherwise it tries again.
+ *
+ * ASSUMPTIONS:
+ *  1) One process writes a segment, any number of processes read it.
+ *  2) Readers attach after the writer has created the segment.
+ *  3) std::atomic<unsigned long long> is lock free, so it works the same across processes.
+ *
+*/
+
+#include "sharednova.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+static const unsigned int SHARED_MAGIC = 0x4E4F5641; // "NOVA"
+static const unsigned int SHARED_LAYOUT_VERSION = 1;
+static const long long SLOTS_OFFSET = 64; // Slots start on their own cache line
+static const int MIN_SLOT_CAPACITY = 64;
+
+static_assert(sizeof(SharedNovaHeader) <= SLOTS_OFFSET, "The header must fit before the slots");
+static_assert(std::atomic<unsigned long long>::is_always_lock_free, "The sequence number must be lock free");
+
+// Pre-Condition: name starts with '/' and names a segment this process may create
+// Post-Condition: Creates an empty segment, throws if it can't be created or the name is already taken, another
+// writer's segment is never truncated. The first publish writes every slot
+SharedNovaSegment::SharedNovaSegment(const std::string& name)
+    : name(name), fd(-1), base(nullptr), mappedBytes(0), fullPublish(true)
+{
+    if (name.size() < 2 || name[0] != '/')
+    {
+        throw std::invalid_argument("Shared memory name must start with '/'");
+    }
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST)
+    {
+        throw std::runtime_error("Shared memory segment already exists");
+    }
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open shared memory segment");
+    }
+
+    try
+    {
+        grow(0);
+    }
+    catch (...)
+    {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw;
+    }
+    new (base) SharedNovaHeader();
+    SharedNovaInfo& info = header()->info;
+    info.magic = SHARED_MAGIC;
+    info.layoutVersion = SHARED_LAYOUT_VERSION;
+    info.segmentBytes = mappedBytes;
+    info.slotsOffset = SLOTS_OFFSET;
+    info.slotCapacity = (int)((mappedBytes - SLOTS_OFFSET) / (long long)sizeof(SharedSlot));
+    info.slotCount = 0;
+    info.liveCount = 0;
+}
+
+// Pre-Condition: None
+// Post-Condition: Unmaps and removes the segment's name, readers that are attached keep their mapping
+SharedNovaSegment::~SharedNovaSegment()
+{
+    munmap(base, mappedBytes);
+    close(fd);
+    shm_unlink(name.c_str());
+}
+
+// Pre-Condition: slot is not negative
+// Post-Condition: The slot is written on the next publish
+void SharedNovaSegment::markChanged(int slot)
+{
+    if (fullPublish)
+    {
+        return;
+    }
+    if (slot >= (int)changedFlags.size())
+    {
+        changedFlags.resize(std::max((size_t)slot + 1, changedFlags.size() * 2), 0);
+    }
+    if (!changedFlags[slot])
+    {
+        changedFlags[slot] = 1;
+        changedSlots.push_back(slot);
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Every slot is written on the next publish, used when the nova's state was replaced as a whole
+void SharedNovaSegment::markAll()
+{
+    fullPublish = true;
+    for (size_t i = 0; i < changedSlots.size(); i++)
+    {
+        changedFlags[changedSlots[i]] = 0;
+    }
+    changedSlots.clear();
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns whether the next publish has to write every slot
+bool SharedNovaSegment::needsFullPublish() const
+{
+    return fullPublish;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the slots changed since the last publish, in the order they first changed
+const std::vector<int>& SharedNovaSegment::getChangedSlots() const
+{
+    return changedSlots;
+}
+
+// Pre-Condition: No write is in progress
+// Post-Condition: The segment holds at least slotCount slots and readers wait until endWrite()
+void SharedNovaSegment::beginWrite(int slotCount, int liveCount)
+{
+    // Growing only adds space past the slots readers know about, so it can happen before the sequence turns odd
+    grow(slotCount);
+
+    SharedNovaHeader* head = header();
+    unsigned long long sequence = head->sequence.load(std::memory_order_relaxed);
+    head->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    head->info.segmentBytes = mappedBytes;
+    head->info.slotCapacity = (int)((mappedBytes - SLOTS_OFFSET) / (long long)sizeof(SharedSlot));
+    head->info.slotCount = slotCount;
+    head->info.liveCount = liveCount;
+}
+
+// Pre-Condition: Called between beginWrite() and endWrite(), slot is below their slot count
+// Post-Condition: The slot holds the lumen's state, or is vacant when lumen is nullptr
+void SharedNovaSegment::writeSlot(int slot, const Lumen* lumen)
+{
+    SharedSlot value = SharedSlot();
+    if (lumen != nullptr)
+    {
+        value.live = 1;
+        value.state = lumen->getState();
+    }
+    memcpy(base + SLOTS_OFFSET + (long long)slot * (long long)sizeof(SharedSlot), &value, sizeof(SharedSlot));
+}
+
+// Pre-Condition: Called after beginWrite()
+// Post-Condition: Readers see the new state, nothing is left to publish
+void SharedNovaSegment::endWrite()
+{
+    for (size_t i = 0; i < changedSlots.size(); i++)
+    {
+        changedFlags[changedSlots[i]] = 0;
+    }
+    changedSlots.clear();
+    fullPublish = false;
+
+    SharedNovaHeader* head = header();
+    head->sequence.store(head->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of publishes so far
+unsigned long long SharedNovaSegment::getVersion() const
+{
+    return header()->sequence.load(std::memory_order_relaxed) / 2;
+}
+
+// Helper method for the header at the start of the mapping
+// Pre-Condition: The segment is mapped
+// Post-Condition: Returns the header
+SharedNovaHeader* SharedNovaSegment::header() const
+{
+    return reinterpret_cast<SharedNovaHeader*>(base);
+}
+
+// Helper method for making room
+// Pre-Condition: slotCount is not negative
+// Post-Condition: The segment and the mapping hold at least slotCount slots, capacity at least doubles when it grows
+void SharedNovaSegment::grow(int slotCount)
+{
+    long long capacity = base != nullptr ? (mappedBytes - SLOTS_OFFSET) / (long long)sizeof(SharedSlot) : 0;
+    if (base != nullptr && slotCount <= capacity)
+    {
+        return;
+    }
+
+    capacity = std::max(std::max((long long)slotCount, capacity * 2), (long long)MIN_SLOT_CAPACITY);
+    long long bytes = SLOTS_OFFSET + capacity * (long long)sizeof(SharedSlot);
+    if (ftruncate(fd, (off_t)bytes) != 0)
+    {
+        throw std::runtime_error("Could not grow shared memory segment");
+    }
+    void* mapped = mmap(nullptr, (size_t)bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Could not map shared memory segment");
+    }
+    if (base != nullptr)
+    {
+        munmap(base, mappedBytes);
+    }
+    base = static_cast<char*>(mapped);
+    mappedBytes = bytes;
+}
+
+// Pre-Condition: name was created by a SharedNovaSegment that is still alive
+// Post-Condition: Maps the segment read only, throws if it can't be opened or isn't a nova segment
+SharedNovaReader::SharedNovaReader(const std::string& name)
+    : fd(-1), base(nullptr), mappedBytes(0)
+{
+    fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open shared memory segment");
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < SLOTS_OFFSET)
+    {
+        close(fd);
+        throw std::runtime_error("Not a shared nova segment");
+    }
+    try
+    {
+        remap((long long)status.st_size);
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+
+    const SharedNovaInfo& info = header()->info;
+    if (info.magic != SHARED_MAGIC || info.layoutVersion != SHARED_LAYOUT_VERSION || info.slotsOffset != SLOTS_OFFSET)
+    {
+        munmap(base, mappedBytes);
+        close(fd);
+        throw std::runtime_error("Not a shared nova segment");
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Unmaps the segment
+SharedNovaReader::~SharedNovaReader()
+{
+    munmap(base, mappedBytes);
+    close(fd);
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the minimum glow query of the last published state, INT_MAX if it has no lumens
+int SharedNovaReader::getMinGlow()
+{
+    int minGlow = INT_MAX;
+    int maxGlow = INT_MIN;
+    glowRange(minGlow, maxGlow);
+    return minGlow;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the maximum glow query of the last published state, INT_MIN if it has no lumens
+int SharedNovaReader::getMaxGlow()
+{
+    int minGlow = INT_MAX;
+    int maxGlow = INT_MIN;
+    glowRange(minGlow, maxGlow);
+    return maxGlow;
+}
+
+// Pre-Condition: Throws exception when slot is out of bounds or vacant in the last published state
+// Post-Condition: Returns the glow query of the lumen in slot
+int SharedNovaReader::glowQuery(int slot)
+{
+    while (true)
+    {
+        SharedNovaInfo info;
+        unsigned long long sequence = beginRead(info);
+        if (slot < 0 || slot >= info.slotCount)
+        {
+            throw std::invalid_argument("Slot to query is out of bounds or vacant");
+        }
+
+        SharedSlot value;
+        memcpy(&value, base + SLOTS_OFFSET + (long long)slot * (long long)sizeof(SharedSlot), sizeof(SharedSlot));
+        if (!endRead(sequence)) continue;
+
+        if (!value.live)
+        {
+            throw std::invalid_argument("Slot to query is out of bounds or vacant");
+        }
+        Lumen lumen(value.state);
+        return lumen.glowQuery();
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of slots in the last published state
+int SharedNovaReader::getSlotCount()
+{
+    SharedNovaInfo info;
+    beginRead(info);
+    return info.slotCount;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of live lumens in the last published state
+int SharedNovaReader::getLumenCount()
+{
+    SharedNovaInfo info;
+    beginRead(info);
+    return info.liveCount;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of publishes the writer has finished
+unsigned long long SharedNovaReader::getVersion() const
+{
+    return header()->sequence.load(std::memory_order_acquire) / 2;
+}
+
+// Helper method for the header at the start of the mapping
+// Pre-Condition: The segment is mapped
+// Post-Condition: Returns the header
+SharedNovaHeader* SharedNovaReader::header() const
+{
+    return reinterpret_cast<SharedNovaHeader*>(base);
+}
+
+// Helper method for starting a consistent read
+// Pre-Condition: None
+// Post-Condition: info is the header of a finished publish that fits in the mapping, returns its sequence number
+unsigned long long SharedNovaReader::beginRead(SharedNovaInfo& info)
+{
+    while (true)
+    {
+        unsigned long long sequence = header()->sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+        {
+            std::this_thread::yield(); // The writer is in the middle of a publish
+            continue;
+        }
+        memcpy(&info, &header()->info, sizeof(SharedNovaInfo));
+        if (!endRead(sequence)) continue;
+
+        // The slot count can only be trusted once the mapping covers the segment it describes
+        if (info.segmentBytes > mappedBytes)
+        {
+            remap(info.segmentBytes);
+            continue;
+        }
+        return sequence;
+    }
+}
+
+// Helper method for finishing a consistent read
+// Pre-Condition: sequence came from beginRead()
+// Post-Condition: Returns whether nothing was published since, so everything read in between is consistent
+bool SharedNovaReader::endRead(unsigned long long sequence) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header()->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+// Helper method for following the segment as it grows
+// Pre-Condition: bytes is the current size of the segment
+// Post-Condition: The whole segment is mapped read only, throws if it can't be mapped
+void SharedNovaReader::remap(long long bytes)
+{
+    void* mapped = mmap(nullptr, (size_t)bytes, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Could not map shared memory segment");
+    }
+    if (base != nullptr)
+    {
+        munmap(base, mappedBytes);
+    }
+    base = static_cast<char*>(mapped);
+    mappedBytes = bytes;
+}
+
+// Helper method shared by the glow queries
+// Pre-Condition: minGlow is INT_MAX and maxGlow is INT_MIN
+// Post-Condition: minGlow and maxGlow hold the glow range of one published state
+void SharedNovaReader::glowRange(int& minGlow, int& maxGlow)
+{
+    while (true)
+    {
+        SharedNovaInfo info;
+        unsigned long long sequence = beginRead(info);
+
+        // One pass over the mapping finds both ends of the range, a slot is copied out only while it is queried
+        int low = INT_MAX;
+        int high = INT_MIN;
+        int slot = 0;
+        for (; slot < info.slotCount; slot++)
+        {
+            SharedSlot value;
+            memcpy(&value, base + SLOTS_OFFSET + (long long)slot * (long long)sizeof(SharedSlot), sizeof(SharedSlot));
+            if (!value.live) continue;
+
+            // A slot a publish is rewriting can mix fields no lumen has, a size of 0 would divide by zero
+            LumenState& state = value.state;
+            if ((state.size <= 0 || state.brightness < 0 || state.power < 0) && !endRead(sequence)) break;
+            Lumen lumen(state);
+            int glow = lumen.glowQuery();
+            if (glow < low) low = glow;
+            if (glow > high) high = glow;
+        }
+        if (slot < info.slotCount || !endRead(sequence)) continue; // A publish overlapped the pass
+
+        minGlow = low;
+        maxGlow = high;
+        return;
+    }
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * The writer's release fence after the odd sequence orders it before the slot writes, and the even store releases
+ * them. A reader's acquire fence before its second sequence load orders its copies before that check, so a copy
+ * that raced a publish always fails endRead().
+ * glowQuery() copies its slot and checks the sequence before building a lumen from it. glowRange() can't copy the
+ * whole slot area first, that is gigabytes for a large nova, so it queries each slot straight from the mapping and
+ * keeps the range only if the sequence held for the whole pass. A torn slot could still reach a glow query before
+ * that check, so a slot with a size, brightness or power no lumen has is checked against the sequence first: the
+ * pass restarts if a publish overlapped it, and otherwise the slot really holds that lumen.
+ * The writer opens its name with O_EXCL, so a second writer or a stale segment left by a crashed process makes the
+ * constructor throw instead of truncating a segment other readers are attached to.
+ * The segment never shrinks, a mapping that covered a slot once still covers it, so a reader with an old mapping can
+ * at worst read a stale header and retry.
+ */
@@ -0,0 +1,109 @@
+/*
+ * sharednova.h
+ *
+ * This file creates the shared memory mode of a nova. A SharedNovaSegment is owned by the nova and mirrors its lumens
+ * into a POSIX shared memory segment, a SharedNovaReader attaches to the segment from any process and runs the glow
+ * queries against it. The segment holds no pointers, every part is found by its offset from the segment start.
+ *
+ */
+
+#ifndef SHAREDNOVA_H
+#define SHAREDNOVA_H
+
+#include "lumen.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+/* Class Invariants:
+    * 1) The sequence number is odd while the writer is changing the segment and even otherwise
+    * 2) A reader only returns results computed between two reads of the same even sequence number
+    * 3) The segment only grows, a reader maps it again when the header says it is larger than its mapping
+    * 4) Slot i of the nova is the SharedSlot at slotsOffset + i * sizeof(SharedSlot)
+    * 5) The writer creates the segment's name and fails if it already exists, it removes the name when it is destroyed
+    *    and attached readers keep their mapping
+    * 6) A reader keeps a result only if it was computed between two reads of the same even sequence number, and builds
+    *    a lumen with a size, brightness or power no lumen has only once the sequence shows the slot wasn't torn
+*/
+
+// One slot of the segment, live is 0 when the slot is vacant
+struct SharedSlot {
+    int live;
+    LumenState state;
+};
+
+// Everything in the header except the sequence number, copied out as a whole by readers
+struct SharedNovaInfo {
+    unsigned int magic;
+    unsigned int layoutVersion;
+    long long segmentBytes; // Size of the segment, readers map it again when it grows
+    long long slotsOffset; // Byte offset of slot 0 from the segment start
+    int slotCapacity;
+    int slotCount;
+    int liveCount;
+};
+
+struct SharedNovaHeader {
+    std::atomic<unsigned long long> sequence;
+    SharedNovaInfo info;
+};
+
+class SharedNovaSegment
+{
+public:
+    explicit SharedNovaSegment(const std::string& name);
+    ~SharedNovaSegment();
+    SharedNovaSegment(const SharedNovaSegment& other) = delete;
+    SharedNovaSegment& operator=(const SharedNovaSegment& other) = delete;
+
+    void markChanged(int slot);
+    void markAll();
+    bool needsFullPublish() const;
+    const std::vector<int>& getChangedSlots() const;
+
+    void beginWrite(int slotCount, int liveCount);
+    void writeSlot(int slot, const Lumen* lumen);
+    void endWrite();
+    unsigned long long getVersion() const;
+
+private:
+    std::string name;
+    int fd;
+    char* base; // Start of the mapping, every other address is base plus an offset
+    long long mappedBytes;
+    bool fullPublish; // Every slot is written on the next publish
+    std::vector<unsigned char> changedFlags;
+    std::vector<int> changedSlots;
+
+    SharedNovaHeader* header() const;
+    void grow(int slotCount);
+};
+
+class SharedNovaReader
+{
+public:
+    explicit SharedNovaReader(const std::string& name);
+    ~SharedNovaReader();
+    SharedNovaReader(const SharedNovaReader& other) = delete;
+    SharedNovaReader& operator=(const SharedNovaReader& other) = delete;
+
+    int getMinGlow();
+    int getMaxGlow();
+    int glowQuery(int slot);
+    int getSlotCount();
+    int getLumenCount();
+    unsigned long long getVersion() const;
+
+private:
+    int fd;
+    char* base;
+    long long mappedBytes;
+
+    SharedNovaHeader* header() const;
+    unsigned long long beginRead(SharedNovaInfo& info);
+    bool endRead(unsigned long long sequence) const;
+    void remap(long long bytes);
+    void glowRange(int& minGlow, int& maxGlow);
+};
+
+#endif
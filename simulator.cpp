@@ -0,0 +1,245 @@
+/*
+ * simulator.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements an event driven simulator for nova. One tick does what glow(getSlotCount()) does:
+ *
+ *     1) lumens past the unstable threshold are reset
+ *     2) if more than half the lumens are inactive, lumens with stable power are recharged
+ *     3) every lumen glows twice
+ *
+ * A lumen's next event is the earliest of
+ *     - the tick where glowing changes its glow state, found with Lumen::glowsUntilStateChange()
+ *     - the tick where its unstable count passes the threshold, two counts per tick while it isn't stable
+ *     - the next tick, if it is already past the threshold and resetting it would change something
+ * A tick only processes the lumens due on it, plus every lumen with stable power when internal recharge runs.
+ * The other lumens are caught up with Lumen::fastForward() the next time they are processed or on sync().
+ *
+ * ASSUMPTIONS:
+ *  1) Nothing else changes the nova between rebuild() and sync().
+ *  2) The recorder isn't told about simulated ticks.
+ *
+*/
+
+#include "simulator.h"
+#include <stdexcept>
+using namespace std;
+
+// Pre-Condition: nova outlives the simulator
+// Post-Condition: The simulator starts at tick 0 with an event scheduled for every lumen that has one
+NovaSimulator::NovaSimulator(Nova& nova)
+    : nova(nova), currentTick(0), processedCount(0), inactiveCount(0)
+{
+    rebuild();
+}
+
+// Pre-Condition: ticks is not negative
+// Post-Condition: Runs the nova forward by ticks, lumens without events on those ticks are left behind until sync()
+void NovaSimulator::advance(long long ticks)
+{
+    if (ticks < 0)
+    {
+        throw std::invalid_argument("Ticks must be non-negative!");
+    }
+
+    long long end = currentTick + ticks;
+    while (currentTick < end)
+    {
+        long long tick = currentTick;
+
+        // Without internal recharge a tick only matters if some lumen has an event on it
+        if (inactiveCount <= nova.liveLumens / 2)
+        {
+            long long next = wheel.nextTick();
+            if (next == TimerWheel::NO_EVENT || next >= end) break;
+            if (next > tick) tick = next;
+        }
+        runTick(tick);
+        currentTick = tick + 1;
+    }
+    currentTick = end;
+}
+
+// Pre-Condition: None
+// Post-Condition: Every lumen is caught up to the current tick, the nova can be read or copied
+void NovaSimulator::sync()
+{
+    for (int i = 0; i < nova.numLumens; i++)
+    {
+        if (!nova.isVacant(i)) catchUp(i, currentTick);
+    }
+}
+
+// Pre-Condition: The nova may have changed since the simulator last ran
+// Post-Condition: Every lumen is treated as current at this tick and its next event is scheduled again
+void NovaSimulator::rebuild()
+{
+    // Every lumen gets its own schedule, so a lazy or spilled nova has to be in memory in full
+    nova.materialize(nova.numLumens);
+    nova.loadAll();
+    int slots = nova.numLumens;
+    wheel.clear();
+    syncedTick.assign(slots, currentTick);
+    eventTick.assign(slots, -1);
+    touchedTick.assign(slots, -1);
+    glowState.assign(slots, LUMEN_INACTIVE);
+    inactiveCount = 0;
+
+    for (int i = 0; i < slots; i++)
+    {
+        if (nova.isVacant(i)) continue;
+        glowState[i] = (unsigned char)nova.lumens[i]->getGlowState();
+        if (!(glowState[i] & LUMEN_ERRATIC)) inactiveCount++;
+        schedule(i);
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of ticks run so far
+long long NovaSimulator::getTick() const
+{
+    return currentTick;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns how many lumen updates processed ticks did, the cost of the simulation so far
+long long NovaSimulator::getProcessedCount() const
+{
+    return processedCount;
+}
+
+// Helper method for running one tick
+// Pre-Condition: No lumen has an event before tick
+// Post-Condition: Every lumen due on tick, and every recharged lumen, is processed through tick
+void NovaSimulator::runTick(long long tick)
+{
+    wheel.popDue(tick, due);
+    touched.clear();
+
+    // Events left over from an earlier schedule of the same lumen are skipped
+    for (size_t i = 0; i < due.size(); i++)
+    {
+        int slot = due[i].id;
+        if (slot >= nova.numLumens || eventTick[slot] != tick || touchedTick[slot] == tick || nova.isVacant(slot)) continue;
+        touch(slot, tick);
+        if (nova.lumens[slot]->getState().unstableCount > nova.UNSTABLE_THRESHOLD)
+        {
+            nova.beginLumenUpdate(slot);
+            nova.lumens[slot]->reset();
+            nova.endLumenUpdate(slot);
+            setGlowState(slot, nova.lumens[slot]->getGlowState());
+        }
+    }
+
+    // Lumens with stable power keep it until their next event, so glowState still tells which ones recharge
+    if (inactiveCount > nova.liveLumens / 2)
+    {
+        for (int i = 0; i < nova.numLumens; i++)
+        {
+            if (nova.isVacant(i) || !(glowState[i] & LUMEN_DORMANT)) continue;
+            if (touchedTick[i] != tick) touch(i, tick);
+            nova.beginLumenUpdate(i);
+            nova.lumens[i]->recharge();
+            nova.endLumenUpdate(i);
+            setGlowState(i, nova.lumens[i]->getGlowState());
+        }
+    }
+
+    for (size_t i = 0; i < touched.size(); i++)
+    {
+        int slot = touched[i];
+        nova.beginLumenUpdate(slot);
+        for (int g = 0; g < GLOWS_PER_TICK; g++)
+        {
+            nova.lumens[slot]->glow();
+        }
+        nova.endLumenUpdate(slot);
+        syncedTick[slot] = tick + 1;
+        setGlowState(slot, nova.lumens[slot]->getGlowState());
+        schedule(slot);
+    }
+    processedCount += (long long)touched.size();
+}
+
+// Helper method for adding a lumen to the current tick
+// Pre-Condition: slot is live and hasn't been touched on tick yet
+// Post-Condition: The lumen is caught up to the start of tick and will glow at its end
+void NovaSimulator::touch(int slot, long long tick)
+{
+    catchUp(slot, tick);
+    touchedTick[slot] = tick;
+    touched.push_back(slot);
+}
+
+// Helper method for catching up a lumen that was left behind
+// Pre-Condition: slot is live and has no event before tick
+// Post-Condition: The lumen reflects every tick before tick
+void NovaSimulator::catchUp(int slot, long long tick)
+{
+    if (syncedTick[slot] >= tick) return;
+    nova.beginLumenUpdate(slot);
+    nova.lumens[slot]->fastForward((tick - syncedTick[slot]) * GLOWS_PER_TICK);
+    nova.endLumenUpdate(slot);
+    syncedTick[slot] = tick;
+}
+
+// Helper method for scheduling a lumen
+// Pre-Condition: slot is live and glowState[slot] matches the lumen
+// Post-Condition: The lumen's next event is in the wheel, any earlier event of it will be skipped
+void NovaSimulator::schedule(int slot)
+{
+    eventTick[slot] = nextEventTick(slot);
+    if (eventTick[slot] >= 0)
+    {
+        wheel.schedule(eventTick[slot], slot);
+    }
+}
+
+// Helper method for predicting a lumen's next event
+// Pre-Condition: slot is live and glowState[slot] matches the lumen
+// Post-Condition: Returns the first tick at or after syncedTick[slot] that has to process the lumen, -1 if none does
+long long NovaSimulator::nextEventTick(int slot) const
+{
+    const Lumen* lumen = nova.lumens[slot];
+    long long start = syncedTick[slot];
+    int unstableCount = lumen->getState().unstableCount;
+    long long next = -1;
+
+    // Past the threshold the lumen is reset on every tick, which only matters while reset() still does something
+    if (unstableCount > nova.UNSTABLE_THRESHOLD)
+    {
+        if (!lumen->resetIsNoOp()) return start;
+    }
+    else if (glowState[slot] != LUMEN_STABLE)
+    {
+        next = start + (nova.UNSTABLE_THRESHOLD - unstableCount) / GLOWS_PER_TICK + 1;
+    }
+
+    int glows = lumen->glowsUntilStateChange();
+    if (glows > 0)
+    {
+        long long change = start + (glows - 1) / GLOWS_PER_TICK;
+        if (next < 0 || change < next) next = change;
+    }
+    return next;
+}
+
+// Helper method for updating the cached glow state
+// Pre-Condition: slot is live
+// Post-Condition: glowState and the inactive count match state
+void NovaSimulator::setGlowState(int slot, int state)
+{
+    inactiveCount += (glowState[slot] & LUMEN_ERRATIC) - (state & LUMEN_ERRATIC);
+    glowState[slot] = (unsigned char)state;
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * A lumen left behind is at the start of a tick with no reset, no recharge and no state change, so catching it up
+ * is only decay and counters.
+ * The unstable count never goes down, so once past the threshold a lumen stays there and is only quiet while
+ * resetIsNoOp() holds.
+ * eventTick is the only event of a lumen that counts, older wheel entries are dropped when they come due.
+ * The glow state bits are used directly: bit 0 (LUMEN_ERRATIC) is isActive, bit 1 (LUMEN_DORMANT) is stable power.
+ */
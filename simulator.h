@@ -0,0 +1,62 @@
+/*
+ * simulator.h
+ *
+ * This file creates a class NovaSimulator that runs a nova for many ticks, where one tick is a glow of every slot.
+ * Instead of touching every lumen on every tick it predicts the tick of each lumen's next event, a change of its glow
+ * state or an unstable count past the threshold, and keeps those ticks in a timer wheel. Lumens between events only
+ * decay, so they are left behind and caught up in one step when something needs them.
+ *
+ */
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "nova.h"
+#include "timerwheel.h"
+#include <vector>
+
+/* Class Invariants:
+    * 1) After sync() the nova is exactly what getTick() calls of glow(getSlotCount()) would have made it
+    * 2) A lumen is only processed on ticks where it has an event or internal recharge runs
+    * 3) Between events a lumen keeps its glow state, so the inactive count only changes on processed ticks
+    * 4) Ticks without events are skipped unless more than half the lumens are inactive, then every tick recharges
+    * 5) The nova must only change through the simulator, call sync() before using it directly and rebuild() after
+*/
+
+class NovaSimulator
+{
+public:
+    explicit NovaSimulator(Nova& nova);
+    NovaSimulator(const NovaSimulator& other) = delete;
+    NovaSimulator& operator=(const NovaSimulator& other) = delete;
+
+    void advance(long long ticks);
+    void sync();
+    void rebuild();
+    long long getTick() const;
+    long long getProcessedCount() const;
+
+private:
+    static const int GLOWS_PER_TICK = 2; // Nova::glow() glows each lumen twice
+
+    Nova& nova;
+    TimerWheel wheel;
+    long long currentTick; // Next tick to run
+    long long processedCount; // Lumen updates done by processed ticks
+    int inactiveCount; // Live lumens whose glow state is inactive
+    std::vector<long long> syncedTick; // Each lumen reflects every tick before this one
+    std::vector<long long> eventTick; // Tick of the lumen's pending event, -1 for none
+    std::vector<long long> touchedTick; // Last tick the lumen was processed on
+    std::vector<unsigned char> glowState; // Glow state at syncedTick, kept until the next event
+    std::vector<TimerEvent> due;
+    std::vector<int> touched; // Lumens processed on the current tick
+
+    void runTick(long long tick);
+    void touch(int slot, long long tick);
+    void catchUp(int slot, long long tick);
+    void schedule(int slot);
+    long long nextEventTick(int slot) const;
+    void setGlowState(int slot, int state);
+};
+
+#endif
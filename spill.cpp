@@ -0,0 +1,163 @@
+/*
+ * spill.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements the scratch file and block table behind a nova's memory budget. A block of n slots is
+ * stored as n SpillRecords starting at block * BLOCK_SLOTS * sizeof(SpillRecord), so rewriting a block never moves
+ * another one and the file needs no free space bookkeeping. Blocks that were never spilled leave holes in the file.
+ *
+ * ASSUMPTIONS:
+ *  1) The file is only read back by the process that wrote it.
+ *  2) The nova decides which blocks to spill and load, the store only keeps their bytes and summaries.
+ *
+*/
+
+#include "spill.h"
+#include <cstdio>
+#include <stdexcept>
+using namespace std;
+
+// Pre-Condition: path can be created, budget is positive
+// Post-Condition: Creates an empty scratch file at path, throws if it can't be opened
+SpillStore::SpillStore(const std::string& path, long long budget)
+    : path(path), budget(budget), useClock(0), spilledLumens(0), stats()
+{
+    if (budget <= 0)
+    {
+        throw std::invalid_argument("Memory budget must be positive!");
+    }
+    file.open(path, ios::in | ios::out | ios::binary | ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Could not open spill file");
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Closes and removes the scratch file
+SpillStore::~SpillStore()
+{
+    file.close();
+    std::remove(path.c_str());
+}
+
+// Pre-Condition: records holds the block's slots in order
+// Post-Condition: The block's bytes are in the file, throws if they can't be written
+void SpillStore::writeBlock(int block, const std::vector<SpillRecord>& records)
+{
+    long long bytes = (long long)records.size() * (long long)sizeof(SpillRecord);
+    file.seekp((streamoff)block * BLOCK_SLOTS * (streamoff)sizeof(SpillRecord));
+    file.write(reinterpret_cast<const char*>(records.data()), bytes);
+    if (!file)
+    {
+        throw std::runtime_error("Could not write spilled block");
+    }
+    stats.blocksEvicted++;
+    stats.bytesWritten += bytes;
+}
+
+// Pre-Condition: The block was written with as many records as records holds
+// Post-Condition: records holds the block's slots, throws if they can't be read
+void SpillStore::readBlock(int block, std::vector<SpillRecord>& records)
+{
+    long long bytes = (long long)records.size() * (long long)sizeof(SpillRecord);
+    file.seekg((streamoff)block * BLOCK_SLOTS * (streamoff)sizeof(SpillRecord));
+    file.read(reinterpret_cast<char*>(records.data()), bytes);
+    if (!file)
+    {
+        throw std::runtime_error("Could not read spilled block");
+    }
+    stats.blocksLoaded++;
+    stats.bytesRead += bytes;
+}
+
+// Pre-Condition: None
+// Post-Condition: Writes of the current batch have reached the file
+void SpillStore::flush()
+{
+    file.flush();
+    if (!file)
+    {
+        throw std::runtime_error("Could not flush spill file");
+    }
+}
+
+// Pre-Condition: block is below getBlockCount()
+// Post-Condition: Returns the block's summary for reading or updating
+SpillBlock& SpillStore::getBlock(int block)
+{
+    return blocks[block];
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of blocks in the table
+int SpillStore::getBlockCount() const
+{
+    return (int)blocks.size();
+}
+
+// Pre-Condition: count is not below the current block count
+// Post-Condition: New blocks are resident and unused
+void SpillStore::setBlockCount(int count)
+{
+    SpillBlock resident = SpillBlock();
+    blocks.resize(count, resident);
+}
+
+// Pre-Condition: The nova dropped every lumen
+// Post-Condition: No block is spilled, counters are kept
+void SpillStore::clear()
+{
+    blocks.clear();
+    spilledLumens = 0;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns a new, larger value of the use clock
+long long SpillStore::nextUse()
+{
+    return ++useClock;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the memory budget in bytes
+long long SpillStore::getBudget() const
+{
+    return budget;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of live lumens in spilled blocks
+long long SpillStore::getSpilledLumens() const
+{
+    return spilledLumens;
+}
+
+// Pre-Condition: count is the change in spilled live lumens, negative when blocks are loaded
+// Post-Condition: The spilled lumen count is updated
+void SpillStore::addSpilledLumens(long long count)
+{
+    spilledLumens += count;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the counters for updating
+SpillStats& SpillStore::getStats()
+{
+    return stats;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the counters
+const SpillStats& SpillStore::getStats() const
+{
+    return stats;
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * A block's offset only depends on its index and a block never holds more than BLOCK_SLOTS records, so rewriting a
+ * block in place never overlaps its neighbour. A partial last block is loaded before the nova adds slots to it.
+ * The file is opened once and kept open, seeks between blocks of a batch go forward since batches are sorted.
+ */
@@ -0,0 +1,88 @@
+/*
+ * spill.h
+ *
+ * This file creates a class SpillStore, the disk tier of a nova with a memory budget. Lumens are spilled in blocks
+ * of fixed size, each block has a fixed place in a scratch file, and a summary of every spilled block stays in memory
+ * so glow() and the queries only page a block back in when its lumens can actually change.
+ *
+ */
+
+#ifndef SPILL_H
+#define SPILL_H
+
+#include "lumen.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Class Invariants:
+    * 1) Block b covers slots [b * BLOCK_SLOTS, (b + 1) * BLOCK_SLOTS) and is stored at a fixed offset of the file
+    * 2) A spilled block's summary matches the lumens in the file, spilled lumens never change
+    * 3) Blocks are written and read in ascending order within a batch
+    * 4) The scratch file is removed when the store is destroyed
+*/
+
+// One slot of a spilled block, live is 0 when the slot is vacant
+struct SpillRecord {
+    int live;
+    LumenState state;
+};
+
+// What glow() and the queries need to know about a block without reading it
+struct SpillBlock {
+    bool spilled;
+    long long lastUse; // Use clock value of the last access, the least recently used blocks are evicted first
+    int live;
+    int inactive;
+    int rechargeable; // Lumens internal recharge would change
+    int replaceable; // Lumens past the unstable threshold whose reset would change them
+    int minGlow;
+    int maxGlow;
+};
+
+// Counters for the disk tier, hits and misses count block accesses
+struct SpillStats {
+    long long hits;
+    long long misses;
+    long long blocksEvicted;
+    long long blocksLoaded;
+    long long bytesWritten;
+    long long bytesRead;
+};
+
+class SpillStore
+{
+public:
+    static const int BLOCK_SLOTS = 4096;
+
+    SpillStore(const std::string& path, long long budget);
+    ~SpillStore();
+    SpillStore(const SpillStore& other) = delete;
+    SpillStore& operator=(const SpillStore& other) = delete;
+
+    void writeBlock(int block, const std::vector<SpillRecord>& records);
+    void readBlock(int block, std::vector<SpillRecord>& records);
+    void flush();
+
+    SpillBlock& getBlock(int block);
+    int getBlockCount() const;
+    void setBlockCount(int count);
+    void clear();
+    long long nextUse();
+    long long getBudget() const;
+    long long getSpilledLumens() const;
+    void addSpilledLumens(long long count);
+    SpillStats& getStats();
+    const SpillStats& getStats() const;
+
+private:
+    std::string path;
+    std::fstream file;
+    long long budget;
+    long long useClock;
+    long long spilledLumens; // Live lumens in spilled blocks
+    std::vector<SpillBlock> blocks;
+    SpillStats stats;
+};
+
+#endif
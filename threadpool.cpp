@@ -0,0 +1,160 @@
+/*
+ * threadpool.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements a small thread pool for data parallel loops. A call publishes the range under a lock,
+ * wakes the workers, and then every thread, the caller included, takes chunks of grain indices from a shared atomic
+ * counter until the range is used up. The caller waits for the workers to finish their last chunk before returning.
+ *
+ * ASSUMPTIONS:
+ *  1) The body only writes to data owned by its own indices, or synchronizes the writes itself.
+ *  2) The body doesn't call parallelFor() on the same pool.
+ *
+*/
+
+#include "threadpool.h"
+#include <stdexcept>
+using namespace std;
+
+// Pre-Condition: threads is not negative, 0 picks one thread per hardware core
+// Post-Condition: Starts threads - 1 workers, the caller of parallelFor() is the last thread
+ThreadPool::ThreadPool(int threads)
+    : nextIndex(0)
+{
+    if (threads < 0)
+    {
+        throw std::invalid_argument("Thread count must be non-negative!");
+    }
+    if (threads == 0)
+    {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+    }
+
+    for (int i = 1; i < threads; i++)
+    {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+// Pre-Condition: No parallelFor() call is running
+// Post-Condition: Stops and joins every worker
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+// Pre-Condition: count and grain are not negative, body can run on any thread
+// Post-Condition: body(begin, end) has run for consecutive chunks covering [0, count) of at most grain indices
+void ThreadPool::parallelFor(int count, int grain, const std::function<void(int, int)>& body)
+{
+    if (count < 0 || grain < 0)
+    {
+        throw std::invalid_argument("Count and grain must be non-negative!");
+    }
+    if (grain == 0) grain = 1;
+
+    // A range that fits in one chunk isn't worth waking anyone for
+    if (count <= grain || workers.empty())
+    {
+        if (count > 0) body(0, count);
+        return;
+    }
+
+    lock_guard<mutex> call(callLock);
+    {
+        lock_guard<mutex> guard(stateLock);
+        this->body = &body;
+        this->count = count;
+        this->grain = grain;
+        this->error = nullptr;
+        nextIndex.store(0);
+        busyWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunks();
+
+    unique_lock<mutex> guard(stateLock);
+    finished.wait(guard, [this] { return busyWorkers == 0; });
+    this->body = nullptr;
+    if (error)
+    {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of threads a call runs on, counting the caller
+int ThreadPool::getThreadCount() const
+{
+    return (int)workers.size() + 1;
+}
+
+// Helper method run by every worker
+// Pre-Condition: None
+// Post-Condition: Runs chunks of each published range until the pool is stopped
+void ThreadPool::workerLoop()
+{
+    long long seen = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> guard(stateLock);
+            wake.wait(guard, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        runChunks();
+
+        lock_guard<mutex> guard(stateLock);
+        if (--busyWorkers == 0)
+        {
+            finished.notify_one();
+        }
+    }
+}
+
+// Helper method shared by the caller and the workers
+// Pre-Condition: A range is published
+// Post-Condition: Takes and runs chunks until none are left, keeping the first exception
+void ThreadPool::runChunks()
+{
+    while (true)
+    {
+        long long begin = nextIndex.fetch_add(grain);
+        if (begin >= count) return;
+        int end = count - begin < grain ? count : (int)begin + grain;
+        try
+        {
+            (*body)((int)begin, end);
+        }
+        catch (...)
+        {
+            lock_guard<mutex> guard(stateLock);
+            if (!error) error = std::current_exception();
+        }
+    }
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * body, count and grain are written under stateLock before generation changes, and workers read them only after
+ * seeing the new generation under the same lock.
+ * busyWorkers counts the workers that haven't finished the current range, the caller waits for it to reach 0, so a
+ * worker never sees a range after its call returned.
+ * nextIndex can run past count by a few chunks, each thread stops at the first chunk that starts past the end.
+ */
@@ -0,0 +1,58 @@
+/*
+ * threadpool.h
+ *
+ * This file creates a class ThreadPool, a fixed set of worker threads that split a range of indices between them.
+ * Novas use it to build and deep copy their lumens in parallel, the calling thread works on the range as well.
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Class Invariants:
+    * 1) Workers are started by the constructor and joined by the destructor, none are created per call
+    * 2) parallelFor() returns only after every chunk of its range has run
+    * 3) Chunks are handed out in order, each index is in exactly one chunk
+    * 4) The first exception thrown by a chunk is rethrown by parallelFor(), the remaining chunks still run
+    * 5) Calls from different threads are run one at a time
+*/
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& body);
+    int getThreadCount() const;
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex callLock; // Held for the whole of a parallelFor() call
+    std::mutex stateLock; // Guards everything below except nextIndex
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(int, int)>* body = nullptr;
+    int count = 0;
+    int grain = 1;
+    std::atomic<long long> nextIndex; // Start of the next chunk, may run past count
+    int busyWorkers = 0;
+    long long generation = 0; // Bumped for every call so workers can tell a new range from a spurious wakeup
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void workerLoop();
+    void runChunks();
+};
+
+#endif
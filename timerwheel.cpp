@@ -0,0 +1,197 @@
+/*
+ * timerwheel.cpp
+ * Date: 10/18/2026
+ *
+ * This program implements a 4 level timer wheel with 64 buckets per level. Level L covers ticks that share every
+ * digit above L with the current tick, where a digit is 6 bits of the tick. When the current tick moves into a new
+ * bucket of a higher level, that bucket's events are placed again and fall to the lower levels.
+ *
+ * ASSUMPTIONS:
+ *  1) Ticks are non-negative and only move forward.
+ *  2) popDue() is called with a tick no later than nextTick(), so no event is ever skipped.
+ *
+*/
+
+#include "timerwheel.h"
+#include <climits>
+#include <stdexcept>
+using namespace std;
+
+// Pre-Condition: None
+// Post-Condition: Creates an empty wheel at tick 0
+TimerWheel::TimerWheel()
+    : now(0), pending(0)
+{
+}
+
+// Pre-Condition: tick is not negative, id identifies the event's owner
+// Post-Condition: The event is pending, a tick in the past is moved to the current tick
+void TimerWheel::schedule(long long tick, int id)
+{
+    if (tick < 0)
+    {
+        throw std::invalid_argument("Tick must be non-negative!");
+    }
+    TimerEvent event;
+    event.tick = tick < now ? now : tick;
+    event.id = id;
+    place(event);
+    pending++;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the earliest tick with a pending event, NO_EVENT if the wheel is empty
+long long TimerWheel::nextTick() const
+{
+    if (pending == 0)
+    {
+        return NO_EVENT;
+    }
+
+    // Level 0 buckets from the current tick on hold single ticks in order
+    for (int b = digit(now, 0); b < BUCKETS; b++)
+    {
+        if (!buckets[0][b].empty())
+        {
+            return buckets[0][b][0].tick;
+        }
+    }
+
+    // Higher levels: the first non-empty bucket after the current one holds the earliest ticks
+    for (int level = 1; level < LEVELS; level++)
+    {
+        for (int b = digit(now, level) + 1; b < BUCKETS; b++)
+        {
+            const vector<TimerEvent>& bucket = buckets[level][b];
+            if (!bucket.empty())
+            {
+                long long earliest = LLONG_MAX;
+                for (size_t i = 0; i < bucket.size(); i++)
+                {
+                    if (bucket[i].tick < earliest) earliest = bucket[i].tick;
+                }
+                return earliest;
+            }
+        }
+    }
+
+    long long earliest = LLONG_MAX;
+    for (size_t i = 0; i < overflow.size(); i++)
+    {
+        if (overflow[i].tick < earliest) earliest = overflow[i].tick;
+    }
+    return earliest;
+}
+
+// Pre-Condition: tick is at or after the current tick and no later than nextTick()
+// Post-Condition: The wheel moves to tick and due receives every event scheduled for it
+void TimerWheel::popDue(long long tick, std::vector<TimerEvent>& due)
+{
+    due.clear();
+    if (tick < now)
+    {
+        return;
+    }
+
+    advanceTo(tick);
+    vector<TimerEvent>& bucket = buckets[0][digit(now, 0)];
+    due.swap(bucket);
+    bucket.clear();
+    pending -= (long long)due.size();
+}
+
+// Pre-Condition: None
+// Post-Condition: Every pending event is dropped, the current tick is kept
+void TimerWheel::clear()
+{
+    for (int level = 0; level < LEVELS; level++)
+    {
+        for (int b = 0; b < BUCKETS; b++)
+        {
+            buckets[level][b].clear();
+        }
+    }
+    overflow.clear();
+    pending = 0;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the tick the wheel was last moved to
+long long TimerWheel::getCurrentTick() const
+{
+    return now;
+}
+
+// Pre-Condition: None
+// Post-Condition: Returns the number of events not popped yet, including ones their owner no longer wants
+long long TimerWheel::getPendingCount() const
+{
+    return pending;
+}
+
+// Helper method for filing an event
+// Pre-Condition: event.tick is at or after the current tick
+// Post-Condition: The event is in the bucket of the lowest level that shares all higher digits with the current tick
+void TimerWheel::place(const TimerEvent& event)
+{
+    for (int level = 0; level < LEVELS; level++)
+    {
+        int shift = (level + 1) * LEVEL_BITS;
+        if ((event.tick >> shift) == (now >> shift))
+        {
+            buckets[level][digit(event.tick, level)].push_back(event);
+            return;
+        }
+    }
+    overflow.push_back(event);
+}
+
+// Helper method for moving the current tick
+// Pre-Condition: tick is no later than the earliest pending event
+// Post-Condition: now is tick and events that share more digits with it have dropped to lower levels
+void TimerWheel::advanceTo(long long tick)
+{
+    long long old = now;
+    now = tick;
+
+    if ((old >> (LEVELS * LEVEL_BITS)) != (now >> (LEVELS * LEVEL_BITS)))
+    {
+        vector<TimerEvent> moving;
+        moving.swap(overflow);
+        for (size_t i = 0; i < moving.size(); i++)
+        {
+            place(moving[i]);
+        }
+    }
+
+    for (int level = LEVELS - 1; level >= 1; level--)
+    {
+        int shift = level * LEVEL_BITS;
+        if ((old >> shift) != (now >> shift))
+        {
+            vector<TimerEvent> moving;
+            moving.swap(buckets[level][digit(now, level)]);
+            for (size_t i = 0; i < moving.size(); i++)
+            {
+                place(moving[i]);
+            }
+        }
+    }
+}
+
+// Helper method for bucket indices
+// Pre-Condition: tick is non-negative
+// Post-Condition: Returns the 6 bit digit of tick for the level
+int TimerWheel::digit(long long tick, int level)
+{
+    return (int)((tick >> (level * LEVEL_BITS)) & (BUCKETS - 1));
+}
+
+/*
+ * IMPLEMENTATION INVARIANTS:
+ *
+ * An event on level L has the same tick >> (6 * (L + 1)) as now, so on level 0 the bucket index is the whole
+ * difference and buckets at or after now's digit are in tick order.
+ * Level L buckets before now's digit are always empty, their events would be in the past.
+ * advanceTo() only needs to redistribute the one bucket per level that now's digit moved onto, higher levels first.
+ */
@@ -0,0 +1,56 @@
+/*
+ * timerwheel.h
+ *
+ * This file creates a class TimerWheel, a hierarchical timer wheel that holds (tick, id) events. Scheduling is O(1),
+ * and finding the next tick that has events skips empty ticks a whole bucket at a time instead of one by one.
+ *
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <vector>
+
+/* Class Invariants:
+    * 1) Every event has a tick at or after the wheel's current tick
+    * 2) An event sits on the lowest level whose bucket is shared with nothing but ticks of the same higher digits,
+    *    so the current level 0 bucket only holds events for the current tick
+    * 3) Events too far ahead for the top level wait in an overflow list
+    * 4) Events are never removed early, owners ignore events they no longer want
+*/
+
+struct TimerEvent
+{
+    long long tick;
+    int id;
+};
+
+class TimerWheel
+{
+public:
+    static const long long NO_EVENT = -1;
+
+    TimerWheel();
+    void schedule(long long tick, int id);
+    long long nextTick() const;
+    void popDue(long long tick, std::vector<TimerEvent>& due);
+    void clear();
+    long long getCurrentTick() const;
+    long long getPendingCount() const;
+
+private:
+    static const int LEVEL_BITS = 6;
+    static const int BUCKETS = 1 << LEVEL_BITS;
+    static const int LEVELS = 4;
+
+    long long now;
+    long long pending;
+    std::vector<TimerEvent> buckets[LEVELS][BUCKETS];
+    std::vector<TimerEvent> overflow;
+
+    void place(const TimerEvent& event);
+    void advanceTo(long long tick);
+    static int digit(long long tick, int level);
+};
+
+#endif